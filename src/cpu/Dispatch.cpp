@@ -0,0 +1,52 @@
+// Dispatch.cpp
+#include "Dispatch.h"
+#include <cstring>
+
+namespace cpu {
+
+CpuLevel detectedCpuLevel() {
+#if SNAKENEAT_CPU_DISPATCH
+    __builtin_cpu_init();
+    bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+                __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2");
+    if (avx2 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512vl"))
+        return CpuLevel::AVX512;
+    if (avx2) return CpuLevel::AVX2;
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt"))
+        return CpuLevel::SSE42;
+#endif
+    return CpuLevel::BASELINE;
+}
+
+static CpuLevel current = CpuLevel::BASELINE;
+
+// pick the best kernels before main() runs
+[[maybe_unused]] static const bool selected = setCpuLevel(detectedCpuLevel());
+
+CpuLevel cpuLevel() { return current; }
+
+bool setCpuLevel(CpuLevel level) {
+    if (int(level) > int(detectedCpuLevel())) return false;
+    current = level;
+    detail::active = &detail::kernelsFor(level);
+    return true;
+}
+
+const char* cpuLevelName(CpuLevel level) {
+    switch (level) {
+        case CpuLevel::BASELINE: return "baseline";
+        case CpuLevel::SSE42:    return "sse4.2";
+        case CpuLevel::AVX2:     return "avx2";
+        case CpuLevel::AVX512:   return "avx512";
+    }
+    return "?";
+}
+
+bool parseCpuLevel(const char* name, CpuLevel& out) {
+    for (CpuLevel l : { CpuLevel::BASELINE, CpuLevel::SSE42, CpuLevel::AVX2, CpuLevel::AVX512 })
+        if (std::strcmp(name, cpuLevelName(l)) == 0) { out = l; return true; }
+    return false;
+}
+
+} // namespace cpu
@@ -0,0 +1,75 @@
+// Dispatch.h
+#pragma once
+#include "neat/Activation.h"
+#include <cstddef>
+#include <cstdint>
+
+// Multiversioned kernels need GCC/Clang target attributes on x86; other
+// builds only have the baseline variant.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SNAKENEAT_CPU_DISPATCH 1
+#else
+#define SNAKENEAT_CPU_DISPATCH 0
+#endif
+
+namespace cpu {
+
+/**
+ * Instruction sets the hot kernels are compiled for. The binary itself
+ * targets the baseline ISA, so it runs on any x86-64 machine; at startup
+ * the best level this CPU supports is selected (cpuid), or a lower one
+ * forced with setCpuLevel() for testing.
+ *
+ *  BASELINE  x86-64 (SSE2)
+ *  SSE42     SSE4.2 + POPCNT
+ *  AVX2      AVX2 + FMA + BMI2
+ *  AVX512    AVX-512 F/BW/VL on top of AVX2
+ */
+enum class CpuLevel { BASELINE, SSE42, AVX2, AVX512 };
+
+/// Best level supported by both this CPU and this build.
+CpuLevel detectedCpuLevel();
+/// Level whose kernels are in use.
+CpuLevel cpuLevel();
+/// Switch kernels; false (nothing changed) if the CPU cannot run them.
+/// Call at startup, before any thread uses kernels().
+bool setCpuLevel(CpuLevel level);
+
+const char* cpuLevelName(CpuLevel level);
+/// Parse "baseline", "sse4.2", "avx2" or "avx512".
+bool parseCpuLevel(const char* name, CpuLevel& out);
+
+/// One step of a flattened network program (Network, RecurrentNetwork).
+struct NetStep {
+    uint32_t         index;       // node slot
+    uint32_t         firstEdge;   // edges [firstEdge, next step's firstEdge)
+    bool             squash;      // apply fn to the node's value
+    neat::Activation fn;
+};
+
+/**
+ * The hot kernels, one table per level. Network kernels never reassociate
+ * floating-point sums (Kernels.cpp is built without FMA contraction), so
+ * every level gives bit-identical networks; the wider ones pay off in the
+ * compatibility sums.
+ */
+struct Kernels {
+    /// Network::feed: for each of the n steps push x[index] along its
+    /// out-edges (dst, w), then activate it.
+    void (*pushProgram)(const NetStep* steps, size_t n, const uint32_t* dst,
+                        const float* w, float* x);
+    /// RecurrentNetwork::feed: next[index] = fn(sum of w * x[src]) per step.
+    void (*pullProgram)(const NetStep* steps, size_t n, const uint32_t* src,
+                        const float* w, const float* x, float* next);
+    /// Compatibility distance: sum of |a[i] - b[i]| (fixed summation order).
+    double (*absDiffSum)(const float* a, const float* b, size_t n);
+};
+
+namespace detail {
+extern const Kernels* active;
+const Kernels& kernelsFor(CpuLevel level);
+}
+
+inline const Kernels& kernels() { return *detail::active; }
+
+} // namespace cpu
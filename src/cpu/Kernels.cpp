@@ -0,0 +1,62 @@
+// Kernels.cpp
+//
+// Kernels.inc compiled once per CpuLevel. Built with -ffp-contract=off
+// (see CMakeLists.txt) so FMA-capable levels round like the others.
+#include "Dispatch.h"
+#include <cmath>
+
+namespace cpu {
+
+#define SNN_TARGET
+namespace baseline {
+#include "Kernels.inc"
+}
+#undef SNN_TARGET
+
+#if SNAKENEAT_CPU_DISPATCH
+#define SNN_TARGET __attribute__((target("sse4.2,popcnt")))
+namespace sse42 {
+#include "Kernels.inc"
+}
+#undef SNN_TARGET
+
+#define SNN_TARGET __attribute__((target("avx2,fma,bmi,bmi2")))
+namespace avx2 {
+#include "Kernels.inc"
+}
+#undef SNN_TARGET
+
+#define SNN_TARGET __attribute__((target("avx512f,avx512bw,avx512vl,avx2,fma,bmi,bmi2")))
+namespace avx512 {
+#include "Kernels.inc"
+}
+#undef SNN_TARGET
+#endif
+
+#define SNN_KERNEL_TABLE(ns) { ns::pushProgram, ns::pullProgram, ns::absDiffSum }
+
+static const Kernels baselineKernels = SNN_KERNEL_TABLE(baseline);
+#if SNAKENEAT_CPU_DISPATCH
+static const Kernels sse42Kernels  = SNN_KERNEL_TABLE(sse42);
+static const Kernels avx2Kernels   = SNN_KERNEL_TABLE(avx2);
+static const Kernels avx512Kernels = SNN_KERNEL_TABLE(avx512);
+#endif
+
+// usable from the first static initializer on; Dispatch.cpp upgrades it
+const Kernels* detail::active = &baselineKernels;
+
+const Kernels& detail::kernelsFor(CpuLevel level) {
+#if SNAKENEAT_CPU_DISPATCH
+    switch (level) {
+        case CpuLevel::AVX512: return avx512Kernels;
+        case CpuLevel::AVX2:   return avx2Kernels;
+        case CpuLevel::SSE42:  return sse42Kernels;
+        case CpuLevel::BASELINE: break;
+    }
+#else
+    (void)level;
+#endif
+    return baselineKernels;
+}
+
+} // namespace cpu
@@ -0,0 +1,453 @@
+// EvalFarm.cpp
+#include "EvalFarm.h"
+#include "game/Game.h"
+#include "neat/GenomeIO.h"
+#include "neat/InnovationTracker.h"
+#include "neat/Network.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <thread>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace farm {
+
+using Clock = std::chrono::steady_clock;
+
+static int msSince(Clock::time_point t) {
+    return int(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - t).count());
+}
+
+static bool makeAddress(const std::string& path, sockaddr_un& addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "EvalFarm: socket path too long: " << path << "\n";
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+static void setNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+// blocking helpers used by the worker side
+static bool writeAll(int fd, const void* data, size_t n) {
+    auto* p = static_cast<const uint8_t*>(data);
+    while (n > 0) {
+        ssize_t k = ::write(fd, p, n);
+        if (k < 0 && errno == EINTR) continue;
+        if (k <= 0) return false;
+        p += k; n -= size_t(k);
+    }
+    return true;
+}
+
+static bool readAll(int fd, void* data, size_t n) {
+    auto* p = static_cast<uint8_t*>(data);
+    while (n > 0) {
+        ssize_t k = ::read(fd, p, n);
+        if (k < 0 && errno == EINTR) continue;
+        if (k <= 0) return false;
+        p += k; n -= size_t(k);
+    }
+    return true;
+}
+
+static FrameHeader makeHeader(uint16_t type, uint32_t batchId, uint32_t count, uint32_t bytes) {
+    return { FRAME_MAGIC, type, PROTOCOL_VERSION, batchId, count, bytes };
+}
+
+// ---------------------------------------------------------------------------
+// Master
+// ---------------------------------------------------------------------------
+
+struct EvalFarm::Batch {
+    enum State { PENDING, IN_FLIGHT, DONE };
+    uint32_t id;
+    size_t first, count;
+    std::vector<uint8_t> payload;
+    State state = PENDING;
+    Clock::time_point sentAt;
+};
+
+struct EvalFarm::Worker {
+    int fd = -1;
+    std::vector<uint8_t> in;
+    std::vector<uint8_t> out;
+    size_t outPos = 0;
+    std::vector<size_t> inFlight;   // indices into the current batch list
+
+    bool flush() {
+        while (outPos < out.size()) {
+            ssize_t k = ::send(fd, out.data() + outPos, out.size() - outPos, 0);
+            if (k < 0 && errno == EINTR) continue;
+            if (k < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+            if (k <= 0) return false;
+            outPos += size_t(k);
+        }
+        out.clear();
+        outPos = 0;
+        return true;
+    }
+};
+
+std::unique_ptr<EvalFarm> EvalFarm::listen(const Options& opts, const GameConfig& cfg) {
+    std::signal(SIGPIPE, SIG_IGN);   // a dead worker must not kill the master
+
+    sockaddr_un addr;
+    if (!makeAddress(opts.socketPath, addr)) return nullptr;
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        std::cerr << "EvalFarm: socket() failed: " << std::strerror(errno) << "\n";
+        return nullptr;
+    }
+    ::unlink(opts.socketPath.c_str());
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(fd, 64) != 0) {
+        std::cerr << "EvalFarm: cannot listen on " << opts.socketPath << ": "
+                  << std::strerror(errno) << "\n";
+        ::close(fd);
+        return nullptr;
+    }
+    setNonBlocking(fd);
+
+    std::unique_ptr<EvalFarm> farm(new EvalFarm());
+    farm->opts_ = opts;
+    farm->opts_.batchSize   = std::max(1, opts.batchSize);
+    farm->opts_.maxInFlight = std::max(1, opts.maxInFlight);
+    farm->cfg_ = cfg;
+    farm->listenFd_ = fd;
+    return farm;
+}
+
+EvalFarm::~EvalFarm() {
+    for (auto& wk : workers_) {
+        queueFrame(*wk, MSG_SHUTDOWN, 0, 0, {});
+        setNonBlocking(wk->fd);
+        wk->flush();
+        ::close(wk->fd);
+    }
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        ::unlink(opts_.socketPath.c_str());
+    }
+    for (pid_t pid : children_) ::waitpid(pid, nullptr, 0);
+}
+
+int EvalFarm::spawnLocalWorkers(int n) {
+    int spawned = 0;
+    for (int i = 0; i < n; ++i) {
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            std::cerr << "EvalFarm: fork() failed: " << std::strerror(errno) << "\n";
+            break;
+        }
+        if (pid == 0) {
+            // child: drop the master's descriptors and serve until shutdown;
+            // _exit skips the parent's static destructors (innovation DB, window)
+            ::close(listenFd_);
+            for (auto& wk : workers_) ::close(wk->fd);
+            ::_exit(runWorker(opts_.socketPath));
+        }
+        children_.push_back(pid);
+        spawned++;
+    }
+    return spawned;
+}
+
+void EvalFarm::queueFrame(Worker& wk, uint16_t type, uint32_t batchId, uint32_t count,
+                          const std::vector<uint8_t>& payload) {
+    FrameHeader h = makeHeader(type, batchId, count, uint32_t(payload.size()));
+    auto* hp = reinterpret_cast<const uint8_t*>(&h);
+    wk.out.insert(wk.out.end(), hp, hp + sizeof(h));
+    wk.out.insert(wk.out.end(), payload.begin(), payload.end());
+}
+
+void EvalFarm::acceptWorkers() {
+    for (;;) {
+        int fd = ::accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) return;
+        setNonBlocking(fd);
+        auto wk = std::make_unique<Worker>();
+        wk->fd = fd;
+        std::vector<uint8_t> cfg(sizeof(GameConfig));
+        std::memcpy(cfg.data(), &cfg_, sizeof(GameConfig));
+        queueFrame(*wk, MSG_CONFIG, 0, 0, cfg);
+        workers_.push_back(std::move(wk));
+    }
+}
+
+void EvalFarm::dropWorker(size_t w, std::vector<Batch>& batches, std::vector<size_t>& pending) {
+    Worker& wk = *workers_[w];
+    for (size_t b : wk.inFlight) {
+        if (batches[b].state == Batch::IN_FLIGHT) {
+            batches[b].state = Batch::PENDING;
+            pending.push_back(b);
+        }
+    }
+    ::close(wk.fd);
+    workers_.erase(workers_.begin() + w);
+}
+
+bool EvalFarm::readFrames(Worker& wk, std::vector<Batch>& batches,
+                          std::vector<neat::FitnessStats>& stats) {
+    uint8_t buf[64 * 1024];
+    for (;;) {
+        ssize_t k = ::recv(wk.fd, buf, sizeof(buf), 0);
+        if (k < 0 && errno == EINTR) continue;
+        if (k < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (k <= 0) return false;   // EOF or error
+        wk.in.insert(wk.in.end(), buf, buf + k);
+    }
+
+    size_t pos = 0;
+    while (wk.in.size() - pos >= sizeof(FrameHeader)) {
+        FrameHeader h;
+        std::memcpy(&h, wk.in.data() + pos, sizeof(h));
+        if (h.magic != FRAME_MAGIC || h.version != PROTOCOL_VERSION || h.bytes > MAX_FRAME_BYTES)
+            return false;
+        if (wk.in.size() - pos - sizeof(h) < h.bytes) break;   // wait for the rest
+        const uint8_t* payload = wk.in.data() + pos + sizeof(h);
+        pos += sizeof(h) + h.bytes;
+
+        if (h.type != MSG_RESULT || batches.empty()) continue;
+        uint32_t firstId = batches.front().id;
+        if (h.batchId < firstId || h.batchId - firstId >= batches.size()) continue;  // stale
+        size_t b = h.batchId - firstId;
+        Batch& batch = batches[b];
+        wk.inFlight.erase(std::remove(wk.inFlight.begin(), wk.inFlight.end(), b), wk.inFlight.end());
+        if (batch.state == Batch::DONE) continue;   // answered by someone else already
+        if (h.count != batch.count || h.bytes != batch.count * 2 * sizeof(double)) return false;
+        for (size_t k = 0; k < batch.count; ++k) {
+            neat::FitnessStats& s = stats[batch.first + k];
+            std::memcpy(&s.mean, payload + (2 * k) * sizeof(double), sizeof(double));
+            std::memcpy(&s.m2,   payload + (2 * k + 1) * sizeof(double), sizeof(double));
+        }
+        batch.state = Batch::DONE;
+    }
+    wk.in.erase(wk.in.begin(), wk.in.begin() + pos);
+    return true;
+}
+
+void EvalFarm::evaluate(const std::vector<neat::Genome*>& genomes,
+                        const std::vector<int>& episodes,
+                        const game::EpisodeSeeds& seeds,
+                        std::vector<neat::FitnessStats>& stats,
+                        const LocalEval& localEval) {
+    stats.assign(genomes.size(), neat::FitnessStats());
+    for (size_t i = 0; i < genomes.size(); ++i) stats[i].episodes = episodes[i];
+    BatchEpisodes plan{ seeds.run, seeds.generation, 0 };
+    auto* pp = reinterpret_cast<const uint8_t*>(&plan);
+
+    // 1) cut the population into encoded batches. Episode lengths cannot
+    //    be predicted (food is random), so batches shrink as the work left
+    //    does: each is about the remainder split across every worker's
+    //    queue, and a batch holding a long episode near the end of the
+    //    generation delays it by little more than that one episode.
+    acceptWorkers();
+    size_t queues = std::max<size_t>(1, workers_.size()) * size_t(opts_.maxInFlight);
+    std::vector<Batch> batches;
+    std::vector<size_t> pending;
+    std::vector<uint8_t> enc;
+    for (size_t first = 0, count; first < genomes.size(); first += count) {
+        count = (genomes.size() - first + queues - 1) / queues;
+        count = std::min(count, size_t(opts_.batchSize));
+        Batch b;
+        b.id    = nextBatchId_++;
+        b.first = first;
+        b.count = count;
+        b.payload.assign(pp, pp + sizeof(plan));
+        bool encoded = true;
+        for (size_t i = first; i < first + b.count && encoded; ++i) {
+            encoded = neat::encodeGenome(*genomes[i], enc);
+            uint32_t n   = uint32_t(episodes[i]);
+            uint32_t len = uint32_t(enc.size());
+            auto* np = reinterpret_cast<const uint8_t*>(&n);
+            auto* lp = reinterpret_cast<const uint8_t*>(&len);
+            b.payload.insert(b.payload.end(), np, np + sizeof(n));
+            b.payload.insert(b.payload.end(), lp, lp + sizeof(len));
+            b.payload.insert(b.payload.end(), enc.begin(), enc.end());
+        }
+        if (!encoded) {
+            // cannot be shipped; evaluate here
+            for (size_t i = first; i < first + b.count; ++i)
+                stats[i] = localEval(*genomes[i], episodes[i]);
+            b.state = Batch::DONE;
+        } else {
+            pending.push_back(batches.size());
+        }
+        batches.push_back(std::move(b));
+    }
+    // hand out batches in order
+    std::reverse(pending.begin(), pending.end());
+
+    auto remaining = [&] {
+        return std::count_if(batches.begin(), batches.end(),
+                             [](const Batch& b) { return b.state != Batch::DONE; });
+    };
+
+    auto lastWorkerSeen = Clock::now();
+    std::vector<pollfd> fds;
+    while (remaining() > 0) {
+        acceptWorkers();
+
+        // 2) keep every worker's pipeline full
+        for (auto& wk : workers_) {
+            while (int(wk->inFlight.size()) < opts_.maxInFlight && !pending.empty()) {
+                size_t b = pending.back(); pending.pop_back();
+                if (batches[b].state == Batch::DONE) continue;   // late answer arrived
+                queueFrame(*wk, MSG_BATCH, batches[b].id, uint32_t(batches[b].count), batches[b].payload);
+                batches[b].state  = Batch::IN_FLIGHT;
+                batches[b].sentAt = Clock::now();
+                wk->inFlight.push_back(b);
+            }
+        }
+
+        // 3) nobody to talk to for a while: do the rest ourselves
+        if (workers_.empty()) {
+            if (msSince(lastWorkerSeen) > opts_.waitForWorkersMs) {
+                for (size_t b : pending) {
+                    if (batches[b].state == Batch::DONE) continue;
+                    for (size_t i = batches[b].first; i < batches[b].first + batches[b].count; ++i)
+                        stats[i] = localEval(*genomes[i], episodes[i]);
+                    batches[b].state = Batch::DONE;
+                }
+                pending.clear();
+                continue;
+            }
+        } else {
+            lastWorkerSeen = Clock::now();
+        }
+
+        // 4) wait for traffic
+        fds.clear();
+        fds.push_back({ listenFd_, POLLIN, 0 });
+        for (auto& wk : workers_)
+            fds.push_back({ wk->fd, short(POLLIN | (wk->out.empty() ? 0 : POLLOUT)), 0 });
+        if (::poll(fds.data(), nfds_t(fds.size()), 100) < 0 && errno != EINTR) {
+            std::cerr << "EvalFarm: poll() failed: " << std::strerror(errno) << "\n";
+            break;
+        }
+
+        // 5) service workers; walk backwards so drops do not shift unvisited ones
+        for (size_t w = workers_.size(); w-- > 0;) {
+            Worker& wk = *workers_[w];
+            short ev = fds[w + 1].revents;
+            bool ok = wk.flush();
+            if (ok && (ev & (POLLIN | POLLHUP | POLLERR)))
+                ok = readFrames(wk, batches, stats);
+            // a worker sitting on a batch past the deadline is presumed lost
+            for (size_t b : wk.inFlight)
+                if (batches[b].state == Batch::IN_FLIGHT &&
+                    msSince(batches[b].sentAt) > opts_.batchTimeoutMs)
+                    ok = false;
+            if (!ok) dropWorker(w, batches, pending);
+        }
+    }
+
+    for (auto& wk : workers_) wk->inFlight.clear();
+}
+
+// ---------------------------------------------------------------------------
+// Worker
+// ---------------------------------------------------------------------------
+
+int runWorker(const std::string& socketPath) {
+    std::signal(SIGPIPE, SIG_IGN);
+    // decoded genomes mint local innovations; they must not reach disk
+    neat::InnovationTracker::getInstance().disablePersistence();
+
+    sockaddr_un addr;
+    if (!makeAddress(socketPath, addr)) return 1;
+    int fd = -1;
+    for (int attempt = 0; attempt < 50 && fd < 0; ++attempt) {
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            ::close(fd);
+            fd = -1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+    if (fd < 0) {
+        std::cerr << "Worker: cannot connect to " << socketPath << "\n";
+        return 1;
+    }
+
+    uint32_t pid = uint32_t(::getpid());
+    FrameHeader hello = makeHeader(MSG_HELLO, 0, 0, sizeof(pid));
+    if (!writeAll(fd, &hello, sizeof(hello)) || !writeAll(fd, &pid, sizeof(pid))) return 1;
+
+    std::unique_ptr<game::Game> game;
+    std::vector<uint8_t> payload;
+    std::vector<double> results;
+    game::EvalResult res;
+    for (;;) {
+        FrameHeader h;
+        if (!readAll(fd, &h, sizeof(h))) break;   // master went away
+        if (h.magic != FRAME_MAGIC || h.version != PROTOCOL_VERSION || h.bytes > MAX_FRAME_BYTES) {
+            std::cerr << "Worker: protocol error\n";
+            break;
+        }
+        payload.resize(h.bytes);
+        if (!readAll(fd, payload.data(), h.bytes)) break;
+
+        if (h.type == MSG_SHUTDOWN) break;
+        if (h.type == MSG_CONFIG && h.bytes == sizeof(GameConfig)) {
+            GameConfig cfg;
+            std::memcpy(&cfg, payload.data(), sizeof(cfg));
+            game::SensorConfig sensors;
+            sensors.fullRays = cfg.fullRays != 0;
+            sensors.patch    = cfg.patch;
+            game = std::make_unique<game::Game>(cfg.gridW, cfg.gridH, cfg.maxTicks, cfg.outputs, sensors);
+            continue;
+        }
+        if (h.type != MSG_BATCH || !game) continue;
+
+        // play every genome in the batch; undecodable ones score 0
+        results.assign(2 * size_t(h.count), 0.0);
+        BatchEpisodes plan{};
+        if (payload.size() >= sizeof(plan)) std::memcpy(&plan, payload.data(), sizeof(plan));
+        game::EpisodeSeeds seeds{ plan.run, plan.generation };
+        size_t pos = sizeof(plan);
+        for (uint32_t i = 0; i < h.count && pos + 2 * sizeof(uint32_t) <= payload.size(); ++i) {
+            uint32_t episodes, len;
+            std::memcpy(&episodes, payload.data() + pos, sizeof(episodes));
+            std::memcpy(&len, payload.data() + pos + sizeof(episodes), sizeof(len));
+            pos += sizeof(episodes) + sizeof(len);
+            if (len > payload.size() - pos) break;
+            neat::Genome g;
+            if (neat::decodeGenome(payload.data() + pos, len, g)) {
+                neat::Network net(g);
+                neat::FitnessStats s;
+                for (uint32_t k = 0; k < episodes; ++k) {
+                    game->evaluate(net, res, seeds(int(k)));
+                    s.add(res.fitness);
+                }
+                results[2 * i]     = s.mean;
+                results[2 * i + 1] = s.m2;
+            }
+            pos += len;
+        }
+        FrameHeader r = makeHeader(MSG_RESULT, h.batchId, h.count,
+                                   uint32_t(results.size() * sizeof(double)));
+        if (!writeAll(fd, &r, sizeof(r)) ||
+            !writeAll(fd, results.data(), results.size() * sizeof(double)))
+            break;
+    }
+    ::close(fd);
+    return 0;
+}
+
+} // namespace farm
@@ -0,0 +1,80 @@
+// EvalFarm.h
+#pragma once
+#include "Protocol.h"
+#include "game/Game.h"
+#include "neat/Genome.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+namespace farm {
+
+/**
+ * @brief  Master side of the evaluation farm (POSIX only).
+ *
+ * Listens on a Unix domain socket, hands out batches of encoded genomes
+ * to whichever workers are connected and collects their fitness values.
+ * Each worker may hold several batches at once so that it never idles
+ * between round trips; batches shrink towards the end of a generation so
+ * that the last ones finish together. Work held by a worker that
+ * disconnects or misses the batch deadline is re-dispatched; if no worker
+ * is around at all the master evaluates locally.
+ */
+class EvalFarm {
+public:
+    struct Options {
+        std::string socketPath;
+        int batchSize        = 8;      ///< max genomes per BATCH message
+        int maxInFlight      = 4;      ///< batches queued per worker
+        int batchTimeoutMs   = 30000;  ///< after this a worker is presumed lost
+        int waitForWorkersMs = 2000;   ///< then fall back to local evaluation
+    };
+
+    /// Bind and listen on opts.socketPath. Returns nullptr on failure.
+    static std::unique_ptr<EvalFarm> listen(const Options& opts, const GameConfig& cfg);
+    ~EvalFarm();
+
+    /// fork() n worker processes on this host that connect back to us.
+    int spawnLocalWorkers(int n);
+
+    /// Play episodes[i] episodes of genomes[i] (episode k with seeds(k))
+    /// and fill stats[i] with their fitness. localEval plays whatever the
+    /// workers cannot take.
+    using LocalEval = std::function<neat::FitnessStats(neat::Genome&, int episodes)>;
+    void evaluate(const std::vector<neat::Genome*>& genomes,
+                  const std::vector<int>& episodes,
+                  const game::EpisodeSeeds& seeds,
+                  std::vector<neat::FitnessStats>& stats,
+                  const LocalEval& localEval);
+
+    int workerCount() const { return int(workers_.size()); }
+
+private:
+    struct Worker;
+    struct Batch;
+
+    EvalFarm() = default;
+    EvalFarm(const EvalFarm&)            = delete;
+    EvalFarm& operator=(const EvalFarm&) = delete;
+
+    void acceptWorkers();
+    void dropWorker(size_t w, std::vector<Batch>& batches, std::vector<size_t>& pending);
+    bool readFrames(Worker& wk, std::vector<Batch>& batches, std::vector<neat::FitnessStats>& stats);
+    void queueFrame(Worker& wk, uint16_t type, uint32_t batchId, uint32_t count,
+                    const std::vector<uint8_t>& payload);
+
+    Options opts_;
+    GameConfig cfg_{};
+    int listenFd_ = -1;
+    uint32_t nextBatchId_ = 1;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<pid_t> children_;
+};
+
+/// Worker loop: connect to a master, evaluate batches until told to stop.
+/// Returns a process exit code.
+int runWorker(const std::string& socketPath);
+
+} // namespace farm
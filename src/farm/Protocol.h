@@ -0,0 +1,59 @@
+// Protocol.h
+#pragma once
+#include <cstdint>
+
+namespace farm {
+
+/**
+ * Wire protocol between the evolution master and evaluation workers.
+ *
+ * Every message is a FrameHeader followed by `bytes` of payload:
+ *   HELLO     worker → master   payload: uint32 pid
+ *   CONFIG    master → worker   payload: GameConfig
+ *   BATCH     master → worker   payload: BatchEpisodes, then
+ *                               `count` × { uint32 episodes, uint32 len, GenomeIO bytes }
+ *   RESULT    worker → master   payload: `count` × { double mean, double m2 }
+ *                               (neat::FitnessStats of the episodes played)
+ *   SHUTDOWN  master → worker   no payload
+ *
+ * Batch IDs are unique for the lifetime of a master, so a late RESULT for
+ * work that has already been re-dispatched is recognized and dropped.
+ * Nothing here depends on the transport being local; only the socket
+ * address family does.
+ */
+constexpr uint32_t FRAME_MAGIC      = 0x4d524653; // "SFRM"
+constexpr uint16_t PROTOCOL_VERSION = 4;
+constexpr uint32_t MAX_FRAME_BYTES  = 64u << 20;
+
+enum MsgType : uint16_t {
+    MSG_HELLO    = 1,
+    MSG_CONFIG   = 2,
+    MSG_BATCH    = 3,
+    MSG_RESULT   = 4,
+    MSG_SHUTDOWN = 5,
+};
+
+struct FrameHeader {
+    uint32_t magic;
+    uint16_t type;
+    uint16_t version;
+    uint32_t batchId;
+    uint32_t count;
+    uint32_t bytes;
+};
+
+struct GameConfig {
+    int32_t gridW, gridH, maxTicks;
+    int32_t fullRays, patch;      // game::SensorConfig
+    int32_t outputs;              // network outputs
+};
+
+// Episode k of every genome in a batch uses food seed
+// game::EpisodeSeeds{run, generation}(k)
+struct BatchEpisodes {
+    uint64_t run;
+    int32_t  generation;
+    uint32_t reserved;
+};
+
+} // namespace farm
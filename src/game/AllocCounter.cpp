@@ -0,0 +1,33 @@
+// AllocCounter.cpp
+#include "AllocCounter.h"
+
+#ifdef SNAKENEAT_COUNT_ALLOCS
+#include <cstdlib>
+#include <new>
+
+static thread_local size_t allocations = 0;
+
+static void* countedAlloc(std::size_t n) {
+    ++allocations;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+// Every other form (arrays, nothrow) forwards to these by default
+void* operator new(std::size_t n) { return countedAlloc(n); }
+void* operator new[](std::size_t n) { return countedAlloc(n); }
+void  operator delete(void* p) noexcept { std::free(p); }
+void  operator delete[](void* p) noexcept { std::free(p); }
+void  operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void  operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace game {
+size_t threadAllocations() { return allocations; }
+bool allocationsCounted() { return true; }
+}
+#else
+namespace game {
+size_t threadAllocations() { return 0; }
+bool allocationsCounted() { return false; }
+}
+#endif
@@ -0,0 +1,18 @@
+// AllocCounter.h
+#pragma once
+#include <cstddef>
+
+namespace game {
+
+/**
+ * Heap allocations made by the calling thread so far. Only counted in
+ * builds configured with -DSNAKENEAT_COUNT_ALLOCS=ON, which replace the
+ * global operator new; otherwise always 0. Used by --check-allocs to hold
+ * Game::evaluate to its zero-allocation episode.
+ */
+size_t threadAllocations();
+
+/// True when this build counts allocations.
+bool allocationsCounted();
+
+} // namespace game
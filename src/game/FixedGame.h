@@ -0,0 +1,186 @@
+// FixedGame.h
+#pragma once
+#include "Game.h"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace game {
+
+// Configurations with a compile-time specialized episode loop. Game picks
+// the one matching its grid and sensors (outputs are always the 4 moves)
+// and plays any other configuration on the generic path. Add a line here
+// to specialize another.
+struct FixedShape { int gridW, gridH, inputs, outputs; };
+constexpr FixedShape FIXED_SHAPES[] = {
+    { 8, 8, 7, 4 },     // the trainer's board with short-ray sensors
+};
+
+/**
+ * @brief  Snake on a W x H board of at most 64 cells.
+ *
+ * The body is one occupancy word plus a ring of cell indices, and every
+ * bound and mask is a constant, so moving, colliding and probing are a
+ * handful of ALU operations. Behaves exactly like Snake.
+ */
+template<int W, int H>
+class FixedSnake {
+    static_assert(W > 0 && H > 0 && W * H <= 64, "occupancy must fit one 64-bit word");
+    static constexpr int CELLS = W * H;
+public:
+    void reset() {
+        x_ = W / 2;
+        y_ = H / 2;
+        head_     = 0;
+        length_   = 1;
+        ring_[0]  = uint8_t(y_ * W + x_);
+        occupied_ = bit(x_, y_);
+        dir_      = Dir::RIGHT;
+        growNext_ = false;
+    }
+
+    void setDirection(Dir d) {
+        // prevent reverse
+        if ((dir_ == Dir::UP && d == Dir::DOWN) || (dir_ == Dir::DOWN && d == Dir::UP) ||
+            (dir_ == Dir::LEFT && d == Dir::RIGHT) || (dir_ == Dir::RIGHT && d == Dir::LEFT))
+            return;
+        dir_ = d;
+    }
+
+    // false on collision; the tail still blocks, it moves after the head
+    bool update() {
+        int x = x_ + DX[int(dir_)], y = y_ + DY[int(dir_)];
+        if (!inside(x, y) || (occupied_ & bit(x, y))) return false;
+        head_ = head_ == 0 ? CELLS - 1 : head_ - 1;
+        ring_[head_] = uint8_t(y * W + x);
+        occupied_ |= bit(x, y);
+        x_ = x;
+        y_ = y;
+        if (growNext_) {
+            growNext_ = false;
+            ++length_;
+        } else {
+            occupied_ &= ~(uint64_t(1) << ring_[(head_ + length_) % CELLS]);
+        }
+        return true;
+    }
+
+    void grow() { growNext_ = true; }
+    Vec2i head() const { return { x_, y_ }; }
+
+    // Snake::getRayCast
+    RayCast rays() const {
+        int d = int(dir_);
+        return { probe(DY[d], -DX[d]), probe(DX[d], DY[d]), probe(-DY[d], DX[d]) };
+    }
+
+private:
+    // indexed by Dir
+    static constexpr int DX[4] = { 0, 0, -1, 1 };
+    static constexpr int DY[4] = { -1, 1, 0, 0 };
+
+    static bool inside(int x, int y) { return unsigned(x) < unsigned(W) && unsigned(y) < unsigned(H); }
+    static uint64_t bit(int x, int y) { return uint64_t(1) << (y * W + x); }
+
+    float probe(int dx, int dy) const {
+        int x = x_, y = y_;
+        for (int i = 1; i <= 3; ++i) {
+            x += dx;
+            y += dy;
+            if (!inside(x, y) || (occupied_ & bit(x, y))) return 1.0f - ((i - 1) / 3.0f);
+        }
+        return 0.0f;
+    }
+
+    std::array<uint8_t, CELLS> ring_;   // body from head_, length_ cells, wrapping
+    uint64_t occupied_;
+    int  x_, y_, head_, length_;
+    Dir  dir_;
+    bool growNext_;
+};
+
+/**
+ * @brief  Game::play for one FixedShape: the same episode, draw for draw
+ *         and bit for bit, with std::array inputs and constant bounds.
+ */
+template<int W, int H, int IN, int OUT>
+struct FixedEpisode {
+    static_assert(IN == 4 + 3, "implements the short-ray sensor layout");
+    static_assert(OUT == 4, "one output per move");
+
+    // Plays into path (cleared) and returns the fitness; last is the final head
+    template<typename N>
+    static double play(N& net, std::mt19937& rng, int maxTicks, std::vector<Vec2i>& path, Vec2i& last) {
+        FixedSnake<W, H> snake;
+        snake.reset();
+        std::uniform_int_distribution<int> distX(0, W - 1), distY(0, H - 1);
+        Vec2i food{ distX(rng), distY(rng) };
+        const double diagonal = std::hypot(W, H);
+        double fitness = 0;
+        path.clear();
+        path.reserve(maxTicks);
+        int ticksSinceLastFood = 0;
+        std::array<float, IN> inputs;
+        for (int t = 0; t < maxTicks; ++t) {
+            ticksSinceLastFood++;
+            Vec2i head = snake.head();
+            RayCast ray = snake.rays();
+            inputs = { float(head.x) / W, float(head.y) / H,
+                       float(food.x - head.x) / W, float(food.y - head.y) / H,
+                       ray.left, ray.front, ray.right };
+            const std::vector<float>& outputs = net.feed(inputs.data(), IN);
+            // first largest output, like std::max_element
+            int dir = 0;
+            if (outputs.size() == size_t(OUT)) {
+                for (int k = 1; k < OUT; ++k)
+                    if (outputs[dir] < outputs[k]) dir = k;
+            } else {
+                for (size_t k = 1; k < outputs.size(); ++k)
+                    if (outputs[dir] < outputs[k]) dir = int(k);
+            }
+            snake.setDirection(static_cast<Dir>(dir));
+            if (!snake.update()) break;  // died
+            head = snake.head();
+            if (head.x == food.x && head.y == food.y) {
+                snake.grow();
+                fitness += 100.0;
+                food = { distX(rng), distY(rng) };
+                ticksSinceLastFood = 0;
+            }
+            double dist = std::hypot(food.x - head.x, food.y - head.y);
+            if (ticksSinceLastFood < 50) fitness += 1.0 - (dist / diagonal);
+            else                         fitness -= 0.01;
+            path.push_back(head);
+        }
+        last = snake.head();
+        return fitness;
+    }
+};
+
+// Index into FIXED_SHAPES of the configuration, or -1
+inline int findFixedShape(int gridW, int gridH, int inputs, int outputs) {
+    for (size_t i = 0; i < sizeof(FIXED_SHAPES) / sizeof(FIXED_SHAPES[0]); ++i) {
+        const FixedShape& s = FIXED_SHAPES[i];
+        if (s.gridW == gridW && s.gridH == gridH && s.inputs == inputs && s.outputs == outputs)
+            return int(i);
+    }
+    return -1;
+}
+
+// Play FIXED_SHAPES[which] (as registered above); false if there is none
+template<size_t I = 0, typename N>
+bool playFixed(int which, N& net, std::mt19937& rng, int maxTicks,
+               std::vector<Vec2i>& path, Vec2i& last, double& fitness) {
+    if constexpr (I < sizeof(FIXED_SHAPES) / sizeof(FIXED_SHAPES[0])) {
+        constexpr FixedShape s = FIXED_SHAPES[I];
+        if (which == int(I)) {
+            fitness = FixedEpisode<s.gridW, s.gridH, s.inputs, s.outputs>::play(net, rng, maxTicks, path, last);
+            return true;
+        }
+        return playFixed<I + 1>(which, net, rng, maxTicks, path, last, fitness);
+    }
+    return false;
+}
+
+} // namespace game
@@ -1,43 +1,93 @@
 // Game.cpp
 #include "Game.h"
 #include "Snake.h"
+#include "FixedGame.h"
 #include <cmath>
 #include <iostream>
 #include <random> 
 #include <algorithm>
+#include <memory>
 using namespace game;
 
-Game::Game(int w, int h, int maxT)
- : gridW_(w), gridH_(h), maxTicks_(maxT)
+Game::Game(int w, int h, int maxT, int outputs, const SensorConfig& sensors)
+ : gridW_(w), gridH_(h), maxTicks_(maxT), sensors_(sensors)
 {
+    fixed_ = findFixedShape(w, h, sensors.inputs(), outputs);
+}
+
+// Stateful networks (RecurrentNetwork) start every episode from scratch
+template<typename N>
+static auto resetState(N& net, int) -> decltype(net.reset(), void()) { net.reset(); }
+template<typename N>
+static void resetState(N&, long) {}
 
+// Per-thread episode state, kept so that episodes stop allocating
+namespace {
+struct Scratch {
+    std::unique_ptr<Snake> snake;
+    std::vector<float> inputs;
+};
 }
 
 template<typename N>
 EvalResult Game::evaluate(N& net) {
+    EvalResult res;
+    evaluate(net, res);
+    return res;
+}
+
+uint64_t EpisodeSeeds::operator()(int episode) const {
+    // splitmix64 of (run, generation, episode)
+    uint64_t z = run ^ (uint64_t(uint32_t(generation)) << 32 | uint32_t(episode));
+    z += 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+template<typename N>
+void Game::evaluate(N& net, EvalResult& out) {
     // each thread gets its own RNG, seeded once
     static thread_local std::mt19937 local_rng(std::random_device{}());
+    play(net, out, local_rng);
+}
+
+template<typename N>
+void Game::evaluate(N& net, EvalResult& out, uint64_t seed) {
+    static thread_local std::mt19937 episode_rng;
+    episode_rng.seed(uint32_t(seed ^ (seed >> 32)));
+    play(net, out, episode_rng);
+}
+
+template<typename N>
+void Game::play(N& net, EvalResult& out, std::mt19937& local_rng) {
+    static thread_local Scratch scratch;
+    resetState(net, 0);
+
+    Vec2i last;
+    if (playFixed(fixed_, net, local_rng, maxTicks_, out.bestPath, last, out.fitness)) {
+        describe(out.bestPath, last, out.behavior);
+        return;
+    }
 
-    Snake snake(gridW_, gridH_);
+    if (!scratch.snake || scratch.snake->gridW() != gridW_ || scratch.snake->gridH() != gridH_)
+        scratch.snake = std::make_unique<Snake>(gridW_, gridH_);
+    Snake& snake = *scratch.snake;
+    snake.reset();
     std::uniform_int_distribution<int> distX(0, gridW_-1),
                                      distY(0, gridH_-1);
     Vec2i food{distX(local_rng), distY(local_rng)};
     double fitness = 0;
-    std::vector<Vec2i> path;
+    std::vector<Vec2i>& path = out.bestPath;
+    path.clear();
+    path.reserve(maxTicks_);
     int ticksSinceLastFood = 0;
+    std::vector<float>& inputs = scratch.inputs;
     for (int t = 0; t < maxTicks_; ++t) {
         ticksSinceLastFood++;
-        // prepare inputs: normalized head pos, food delta
-        float hx = float(snake.head().x)/gridW_,
-              hy = float(snake.head().y)/gridH_,
-              fx = float(food.x - snake.head().x)/gridW_,
-              fy = float(food.y - snake.head().y)/gridH_;
-        auto ray = snake.getRayCast();
-        float left  = std::get<0>(ray);
-        float front = std::get<1>(ray);
-        float right = std::get<2>(ray);
-
-        auto outputs = net.feed({hx, hy, fx, fy, left, front, right});
+        // prepare inputs: normalized head pos, food delta, sensors
+        sense(snake, food, sensors_, inputs);
+        const auto& outputs = net.feed(inputs);
         // auto outputs = net.feed({hx, hy, fx, fy,});
         // pick largest output -> direction
         int dir = std::distance(outputs.begin(),
@@ -61,14 +111,47 @@ EvalResult Game::evaluate(N& net) {
         }
         path.push_back(snake.head());
     }
-    return {fitness, path};
+    out.fitness = fitness;
+    describe(path, snake.head(), out.behavior);
+}
+
+void Game::describe(const std::vector<Vec2i>& path, Vec2i last, std::vector<float>& b) const {
+    b.assign(BEHAVIOR_DIM, 0.0f);
+    if (!path.empty()) {
+        float share = 1.0f / path.size();
+        for (const Vec2i& p : path) {
+            int bx = std::clamp(p.x * BEHAVIOR_BINS / gridW_, 0, BEHAVIOR_BINS - 1);
+            int by = std::clamp(p.y * BEHAVIOR_BINS / gridH_, 0, BEHAVIOR_BINS - 1);
+            b[by * BEHAVIOR_BINS + bx] += share;
+        }
+    }
+    b[BEHAVIOR_BINS * BEHAVIOR_BINS]     = std::clamp(float(last.x) / std::max(1, gridW_ - 1), 0.0f, 1.0f);
+    b[BEHAVIOR_BINS * BEHAVIOR_BINS + 1] = std::clamp(float(last.y) / std::max(1, gridH_ - 1), 0.0f, 1.0f);
+    b[BEHAVIOR_BINS * BEHAVIOR_BINS + 2] = float(path.size()) / maxTicks_;
 }
 
 #include "neat/Network.h"
+#include "neat/NetworkJit.h"
+#include "neat/QuantizedNetwork.h"
+#include "neat/RecurrentNetwork.h"
 
 namespace game {
   // force MSVC to emit the evaluate<Network> symbol
   template EvalResult Game::evaluate<neat::Network>(neat::Network& net);
+  template EvalResult Game::evaluate<neat::JitNetwork>(neat::JitNetwork& net);
+  template EvalResult Game::evaluate<neat::QuantizedNetwork>(neat::QuantizedNetwork& net);
+  template EvalResult Game::evaluate<neat::QuantizationCheck>(neat::QuantizationCheck& net);
+  template EvalResult Game::evaluate<neat::RecurrentNetwork>(neat::RecurrentNetwork& net);
+  template void Game::evaluate<neat::Network>(neat::Network& net, EvalResult& out);
+  template void Game::evaluate<neat::JitNetwork>(neat::JitNetwork& net, EvalResult& out);
+  template void Game::evaluate<neat::QuantizedNetwork>(neat::QuantizedNetwork& net, EvalResult& out);
+  template void Game::evaluate<neat::QuantizationCheck>(neat::QuantizationCheck& net, EvalResult& out);
+  template void Game::evaluate<neat::RecurrentNetwork>(neat::RecurrentNetwork& net, EvalResult& out);
+  template void Game::evaluate<neat::Network>(neat::Network& net, EvalResult& out, uint64_t seed);
+  template void Game::evaluate<neat::JitNetwork>(neat::JitNetwork& net, EvalResult& out, uint64_t seed);
+  template void Game::evaluate<neat::QuantizedNetwork>(neat::QuantizedNetwork& net, EvalResult& out, uint64_t seed);
+  template void Game::evaluate<neat::QuantizationCheck>(neat::QuantizationCheck& net, EvalResult& out, uint64_t seed);
+  template void Game::evaluate<neat::RecurrentNetwork>(neat::RecurrentNetwork& net, EvalResult& out, uint64_t seed);
 }
 
 // Explicit instantiation for our Network type will go in main.cpp.
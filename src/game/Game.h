@@ -1,24 +1,59 @@
 // Game.h
 #pragma once
 #include "Snake.h"
+#include "Sensors.h"
+#include <cstdint>
 #include <vector>
 #include <random>
 
 namespace game {
 
+// Behavior characterization used by novelty search: share of ticks the
+// head spent in each cell of a BEHAVIOR_BINS x BEHAVIOR_BINS coarse grid,
+// the final head position and the fraction of maxTicks survived.
+constexpr int BEHAVIOR_BINS = 4;
+constexpr int BEHAVIOR_DIM  = BEHAVIOR_BINS * BEHAVIOR_BINS + 3;
+
 struct EvalResult {
     double fitness;
     std::vector<Vec2i> bestPath; // for visualization
+    std::vector<float> behavior; // BEHAVIOR_DIM values in [0, 1]
+};
+
+// Food seeds of one generation's episodes. Episode k of every genome in a
+// generation spawns the same food (common random numbers), so fitness
+// differences come from the networks rather than from the draw.
+struct EpisodeSeeds {
+    uint64_t run = 0;
+    int generation = 0;
+    uint64_t operator()(int episode) const;
 };
 
 class Game {
 public:
-    Game(int gridW, int gridH, int maxTicks);
+    // outputs: the network's output count (one per move, argmax)
+    Game(int gridW, int gridH, int maxTicks, int outputs, const SensorConfig& sensors = SensorConfig());
+    const SensorConfig& sensors() const { return sensors_; }
+    // Plays a compile-time specialized episode loop (see FixedGame.h)
+    bool specialized() const { return fixed_ >= 0; }
     // Run one simulation for given neural network; return fitness & path
     template<typename NetworkT>
     EvalResult evaluate(NetworkT& net);
+    // Same, into out, reusing its buffers: once they (and this thread's
+    // scratch) have grown, an episode makes no heap allocations
+    template<typename NetworkT>
+    void evaluate(NetworkT& net, EvalResult& out);
+    // Same, with food spawned from seed instead of this thread's RNG
+    template<typename NetworkT>
+    void evaluate(NetworkT& net, EvalResult& out, uint64_t seed);
 private:
+    template<typename NetworkT>
+    void play(NetworkT& net, EvalResult& out, std::mt19937& rng);
+    void describe(const std::vector<Vec2i>& path, Vec2i last, std::vector<float>& b) const;
+
     int gridW_, gridH_, maxTicks_;
+    SensorConfig sensors_;
+    int fixed_ = -1;                // index into FIXED_SHAPES
    
 };
 } // namespace game
@@ -0,0 +1,70 @@
+// Sensors.cpp
+#include "Sensors.h"
+#include "Snake.h"
+#include <algorithm>
+
+namespace game {
+
+bool parseRays(const std::string& name, SensorConfig& cfg) {
+    if      (name == "short") cfg.fullRays = false;
+    else if (name == "full")  cfg.fullRays = true;
+    else return false;
+    return true;
+}
+
+// forward and right unit vectors of a heading (y grows downwards)
+static void frame(Dir d, Vec2i& fwd, Vec2i& rgt) {
+    switch (d) {
+        case Dir::UP:    fwd = {0, -1}; rgt = {1, 0};  break;
+        case Dir::DOWN:  fwd = {0, 1};  rgt = {-1, 0}; break;
+        case Dir::LEFT:  fwd = {-1, 0}; rgt = {0, -1}; break;
+        case Dir::RIGHT: fwd = {1, 0};  rgt = {0, 1};  break;
+    }
+}
+
+void sense(const Snake& snake, const Vec2i& food, const SensorConfig& cfg, std::vector<float>& out) {
+    const int W = snake.gridW(), H = snake.gridH();
+    const Vec2i head = snake.head();
+    out.resize(size_t(cfg.inputs()));
+    float* o = out.data();
+    *o++ = float(head.x) / W;
+    *o++ = float(head.y) / H;
+    *o++ = float(food.x - head.x) / W;
+    *o++ = float(food.y - head.y) / H;
+
+    Vec2i fwd{0, 0}, rgt{0, 0};
+    frame(snake.direction(), fwd, rgt);
+
+    if (!cfg.fullRays) {
+        RayCast ray = snake.getRayCast();
+        *o++ = ray.left;
+        *o++ = ray.front;
+        *o++ = ray.right;
+    } else {
+        // front, front-right, right, ... clockwise in the heading's frame
+        const int turns[8][2] = { {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1} };
+        for (const auto& t : turns) {
+            int dx = t[0] * fwd.x + t[1] * rgt.x;
+            int dy = t[0] * fwd.y + t[1] * rgt.y;
+            int body = snake.bodySteps(dx, dy);
+            // food on the ray: a positive multiple k of (dx, dy) away
+            int fx = food.x - head.x, fy = food.y - head.y;
+            int k = dx != 0 ? fx * dx : fy * dy;
+            bool onRay = k > 0 && fx == k * dx && fy == k * dy;
+            *o++ = 1.0f / snake.wallSteps(dx, dy);
+            *o++ = body > 0 ? 1.0f / body : 0.0f;
+            *o++ = onRay ? 1.0f / k : 0.0f;
+        }
+    }
+
+    // rows from ahead to behind, columns from left to right
+    for (int f = cfg.patch; f >= -cfg.patch; --f) {
+        for (int r = -cfg.patch; r <= cfg.patch; ++r) {
+            if (f == 0 && r == 0) continue;
+            Vec2i c{ head.x + f * fwd.x + r * rgt.x, head.y + f * fwd.y + r * rgt.y };
+            *o++ = (!snake.inside(c) || snake.occupied(c)) ? 1.0f : 0.0f;
+        }
+    }
+}
+
+} // namespace game
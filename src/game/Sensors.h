@@ -0,0 +1,37 @@
+// Sensors.h
+#pragma once
+#include <string>
+#include <vector>
+
+namespace game {
+
+class Snake;
+struct Vec2i;
+
+// What the network observes each tick. Every layout starts with the head
+// position and the food offset (hx, hy, fx, fy), normalized by the grid:
+//  - short rays: 1 - (d-1)/3 for an obstacle d <= 3 cells away to the
+//    left, front and right, else 0                            (3 inputs)
+//  - full rays:  for 8 directions relative to the heading (front, then
+//    clockwise), 1/d to the wall, to the nearest body cell and to the
+//    food if it lies on that ray (0 if nothing is)            (24 inputs)
+//  - patch R:    1 for each blocked (wall or body) cell of the square of
+//    radius R around the head, in the heading's frame ((2R+1)^2 - 1 inputs)
+// Rays come from Snake's occupancy bitsets, so they cost the same at any
+// snake length.
+struct SensorConfig {
+    bool fullRays = false;
+    int  patch    = 0;     // radius; 0: no patch
+
+    int inputs() const {
+        return 4 + (fullRays ? 24 : 3) + (patch > 0 ? (2 * patch + 1) * (2 * patch + 1) - 1 : 0);
+    }
+};
+
+// "short" or "full"; false for anything else
+bool parseRays(const std::string& name, SensorConfig& cfg);
+
+// Write cfg.inputs() observations of snake and food into out
+void sense(const Snake& snake, const Vec2i& food, const SensorConfig& cfg, std::vector<float>& out);
+
+} // namespace game
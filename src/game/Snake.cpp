@@ -1,21 +1,121 @@
 // Snake.cpp
 #include "Snake.h"
+#include <algorithm>
 #include <iostream>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 using namespace game;
 
+static inline int lowestBit(uint64_t v) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward64(&i, v);
+    return int(i);
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+static inline int highestBit(uint64_t v) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanReverse64(&i, v);
+    return int(i);
+#else
+    return 63 - __builtin_clzll(v);
+#endif
+}
+
+// first set bit above / last set bit below p in a line of `words` words, or -1
+static int nextSet(const uint64_t* line, size_t words, int p) {
+    size_t w = size_t(p + 1) >> 6;
+    if (w >= words) return -1;
+    uint64_t bits = line[w] & (~uint64_t(0) << ((p + 1) & 63));
+    while (!bits) {
+        if (++w == words) return -1;
+        bits = line[w];
+    }
+    return int(w << 6) + lowestBit(bits);
+}
+
+static int prevSet(const uint64_t* line, int p) {
+    if (p <= 0) return -1;
+    size_t w = size_t(p) >> 6;
+    uint64_t bits = line[w] & ((uint64_t(1) << (p & 63)) - 1);
+    while (!bits) {
+        if (w-- == 0) return -1;
+        bits = line[w];
+    }
+    return int(w << 6) + highestBit(bits);
+}
+
 Snake::Snake(int w, int h)
- : gridW_(w), gridH_(h), dir_(Dir::RIGHT), growNext_(false)
+ : gridW_(w), gridH_(h), dir_(Dir::RIGHT), growNext_(false),
+   words_((size_t(std::max(w, h)) + 63) / 64)
 {
+    // the body never outgrows the grid, so moving and growing never allocate
+    segments_.reserve(size_t(w) * size_t(h) + 1);
+    lines_[ROW].resize(size_t(h) * words_);
+    lines_[COL].resize(size_t(w) * words_);
+    lines_[DIAG].resize(size_t(w + h - 1) * words_);
+    lines_[ANTI].resize(size_t(w + h - 1) * words_);
     reset();
 }
 
 void Snake::reset() {
+    for (auto& l : lines_) std::fill(l.begin(), l.end(), 0);
     segments_.clear();
     segments_.push_back({gridW_/2, gridH_/2});
+    setCell(segments_.front(), true);
     dir_ = Dir::RIGHT;
     growNext_ = false;
 }
 
+size_t Snake::lineBase(Line l, Vec2i c) const {
+    switch (l) {
+        case ROW:  return size_t(c.y) * words_;
+        case COL:  return size_t(c.x) * words_;
+        case DIAG: return size_t(c.x - c.y + gridH_ - 1) * words_;   // x - y constant
+        default:   return size_t(c.x + c.y) * words_;                // x + y constant
+    }
+}
+
+void Snake::setCell(Vec2i c, bool on) {
+    for (int l = 0; l < LINES; ++l) {
+        int b = lineBit(Line(l), c);
+        uint64_t& w = lines_[l][lineBase(Line(l), c) + size_t(b >> 6)];
+        uint64_t m = uint64_t(1) << (b & 63);
+        w = on ? (w | m) : (w & ~m);
+    }
+}
+
+bool Snake::occupied(Vec2i c) const {
+    return (lines_[ROW][lineBase(ROW, c) + size_t(c.x >> 6)] >> (c.x & 63)) & 1;
+}
+
+int Snake::wallSteps(int dx, int dy) const {
+    Vec2i h = head();
+    int steps = gridW_ + gridH_;
+    if (dx > 0) steps = std::min(steps, gridW_ - h.x);
+    if (dx < 0) steps = std::min(steps, h.x + 1);
+    if (dy > 0) steps = std::min(steps, gridH_ - h.y);
+    if (dy < 0) steps = std::min(steps, h.y + 1);
+    return steps;
+}
+
+int Snake::bodySteps(int dx, int dy) const {
+    // the line through the head along (dx, dy); moving along it changes
+    // the bit index by one per step (x for rows and diagonals, y for columns)
+    Vec2i h = head();
+    Line l = dy == 0 ? ROW : dx == 0 ? COL : dx == dy ? DIAG : ANTI;
+    const uint64_t* line = lines_[l].data() + lineBase(l, h);
+    int p = lineBit(l, h);
+    int forward = l == COL ? dy : dx;
+    int hit = forward > 0 ? nextSet(line, words_, p) : prevSet(line, p);
+    return hit < 0 ? 0 : std::abs(hit - p);
+}
+
 void Snake::setDirection(Dir d) {
     // prevent reverse
     if ((dir_ == Dir::UP && d == Dir::DOWN) ||
@@ -28,20 +128,10 @@ void Snake::setDirection(Dir d) {
 
 
 
-std::tuple<float, float, float> Snake::getRayCast() const {
-    auto isBlocked = [&](Vec2i pos) {
-        // Check wall
-        if (pos.x < 0 || pos.x >= gridW_ || pos.y < 0 || pos.y >= gridH_)
-            return true;
-        // Check body
-        for (const auto& seg : segments_)
-            if (seg == pos)
-                return true;
-        return false;
-    };
+RayCast Snake::getRayCast() const {
 
     // Directions relative to current
-    Vec2i fwd, lft, rgt;
+    Vec2i fwd{0, 0}, lft{0, 0}, rgt{0, 0};
     switch (dir_) {
         case Dir::UP:    fwd = {0, -1}; lft = {-1, 0}; rgt = {1, 0}; break;
         case Dir::DOWN:  fwd = {0, 1};  lft = {1, 0};  rgt = {-1, 0}; break;
@@ -50,14 +140,9 @@ std::tuple<float, float, float> Snake::getRayCast() const {
     }
 
     auto checkDir = [&](Vec2i dirVec) -> float {
-        Vec2i pos = head();
-        for (int i = 1; i <= 3; ++i) {
-            pos.x += dirVec.x;
-            pos.y += dirVec.y;
-            if (isBlocked(pos))
-                return 1.0f - ((i - 1) / 3.0f);
-        }
-        return 0.0f;
+        int body = bodySteps(dirVec.x, dirVec.y);
+        int i = std::min(wallSteps(dirVec.x, dirVec.y), body > 0 ? body : 4);
+        return i <= 3 ? 1.0f - ((i - 1) / 3.0f) : 0.0f;
     };
 
     float leftDist   = checkDir(lft);
@@ -81,16 +166,17 @@ bool Snake::update() {
         //std::cout << "wall" << std::endl;
         return false;
     }
-    // self collision
-    for (auto& s : segments_)
-        if (s.x == head.x && s.y == head.y){
-            //std::cout << "self" << std::endl;
-            return false;
-        }
+    // self collision (the tail still blocks: it moves after the head)
+    if (occupied(head)) {
+        //std::cout << "self" << std::endl;
+        return false;
+    }
     segments_.insert(segments_.begin(), head);
+    setCell(head, true);
     if (growNext_) {
         growNext_ = false;
     } else {
+        setCell(segments_.back(), false);
         segments_.pop_back();
     }
     return true;
@@ -1,5 +1,6 @@
 // Snake.h
 #pragma once
+#include <cstdint>
 #include <vector>
 #include <raylib.h>
 
@@ -14,21 +15,50 @@ struct Vec2i {
     }
 };
 
+// Obstacle proximity along the three directions the snake can turn to:
+// 1 = blocked next cell, 0 = clear for 3 cells
+struct RayCast {
+    float left, front, right;
+};
+
+// The body is also kept as occupancy bitsets along every row, column,
+// diagonal and anti-diagonal of the grid, updated as the head advances
+// and the tail retracts. Collision tests are one bit test and the nearest
+// body cell along any of the 8 directions is a masked bit scan, so
+// neither depends on the snake's length.
 class Snake {
 public:
     Snake(int gridW, int gridH);
     void reset();
     void setDirection(Dir d);
-    std::tuple<float, float, float> getRayCast() const;
+    RayCast getRayCast() const;
     bool update(); // returns false on collision
     const std::vector<Vec2i>& body() const;
     Vec2i head() const;
+    Dir direction() const { return dir_; }
     void grow();
+    int gridW() const { return gridW_; }
+    int gridH() const { return gridH_; }
+
+    bool inside(Vec2i c) const { return c.x >= 0 && c.x < gridW_ && c.y >= 0 && c.y < gridH_; }
+    bool occupied(Vec2i c) const;   // c must be inside
+    // Steps from the head along (dx, dy) (each -1, 0 or 1) to the first
+    // wall cell outside the grid / to the nearest body cell (0: none)
+    int wallSteps(int dx, int dy) const;
+    int bodySteps(int dx, int dy) const;
 private:
+    enum Line { ROW, COL, DIAG, ANTI, LINES };
+    void setCell(Vec2i c, bool on);
+    // bits of line family l for cell c: word offset and bit index
+    size_t lineBase(Line l, Vec2i c) const;
+    int    lineBit(Line l, Vec2i c) const { return l == COL ? c.y : c.x; }
+
     int gridW_, gridH_;
     std::vector<Vec2i> segments_;
     Dir dir_;
     bool growNext_;
+    size_t words_;                       // uint64 words per line
+    std::vector<uint64_t> lines_[LINES];
 };
 
 } // namespace game
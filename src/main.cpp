@@ -4,16 +4,38 @@
 #include <vector>
 #include <random>
 #include <algorithm>
+#include <memory>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <deque>
 #include <raylib.h>
 
 // Project headers
 #include "game/Game.h"
 #include "game/Snake.h"
+#include "game/AllocCounter.h"
+#include "cpu/Dispatch.h"
 #include "neat/NEAT.h"
 #include "neat/Network.h"
+#include "neat/NetworkJit.h"
+#include "neat/QuantizedNetwork.h"
+#include "neat/RecurrentNetwork.h"
+#include "neat/ChampionExport.h"
+#include "neat/Activation.h"
+#include "neat/Novelty.h"
 #include "render/Renderer.h"
-
-int main() {
+#include "telemetry/Sampler.h"
+#include "sweep/Sweep.h"
+#include "sweep/ThreadPool.h"
+#ifdef SNAKENEAT_HAVE_POSIX_IPC
+#include "neat/Migration.h"
+#include "farm/EvalFarm.h"
+#include "telemetry/LiveMonitor.h"
+#endif
+
+int main(int argc, char** argv) {
     // ------------------------------------------------------------------------
     // Simulation parameters 
     // ------------------------------------------------------------------------
@@ -22,7 +44,6 @@ int main() {
     const int MAX_TICKS    = 1000;   ///< max steps per simulation
 
     const int POP_SIZE     = 100;    ///< genomes per generation
-    const int INPUT_N      = 7;     ///< network input size (hx, hy, fx, fy)
     const int OUTPUT_N     = 4;     ///< network outputs (UP,DOWN,LEFT,RIGHT)
     const int GENERATIONS  = 1000;   ///< total training generations
 
@@ -32,83 +53,633 @@ int main() {
     const int SCREEN_W = 1200;       ///< game width  (pixels)
     const int SCREEN_H = 600;       ///< game height (pixels)
 
+    // ------------------------------------------------------------------------
+    // Command line
+    //   --migrate NAME      exchange elites with other trainers through the
+    //                       shared-memory ring NAME (island model)
+    //   --migrate-every N   generations between migrations      (default 10)
+    //   --migrants K        max genomes imported per migration   (default 2)
+    //   --farm PATH         evaluate on worker processes reached through
+    //                       the Unix domain socket PATH
+    //   --farm-workers N    fork N local workers for the farm     (default 0)
+    //   --farm-batch B      max genomes per batch per worker      (default 8)
+    //   --worker PATH       run as an evaluation worker for a master at PATH
+    //   --jit               compile each generation's champion to native
+    //                       code; elites that survive unchanged run it
+    //   --quantized         evaluate with the int8 network
+    //   --check-quantized   as --quantized, and report how often its moves
+    //                       differ from the float network's
+    //   --headless          no window: train, then exit without the demo
+    //   --sensors short|full   3 short obstacle rays (default) or 8-direction
+    //                       wall/body/food distances (see game/Sensors.h)
+    //   --sensor-patch R    also observe the cells within R of the head
+    //   --episodes K        episodes per genome and generation, on food
+    //                       seeds shared by the population     (default 1)
+    //   --max-episodes M    genomes carried over unchanged keep adding
+    //                       episodes until they have M, then reuse their
+    //                       running mean without playing        (default 8)
+    //   --check-allocs      replay each champion and report heap allocations
+    //                       in its episode (exit status 1 with --headless);
+    //                       needs a -DSNAKENEAT_COUNT_ALLOCS=ON build
+    //   --monitor NAME      publish champion and stats to the shared-memory
+    //                       segment NAME for snake-viewer to attach to
+    //   --pipeline          evaluate offspring on a thread pool while the
+    //                       previous generation is bred and drawn
+    //   --recurrent         let add-connection close cycles; evaluate with
+    //                       RecurrentNetwork (state carried across ticks)
+    //   --export PATH       after training, write the best champion seen in
+    //                       the standalone format run by snake-player
+    //   --activation F      hidden+output activation: tanh, fast-tanh,
+    //                       lut-tanh, sigmoid, relu, linear
+    //   --hidden-activation F / --output-activation F   per node type
+    //   --check-activations report each activation's error and cost per
+    //                       value, then exit (status 1 if a bound fails)
+    //   --cpu LEVEL         force the kernel variant: baseline, sse4.2, avx2,
+    //                       avx512 (default: best this CPU supports)
+    //   --telemetry PATH    append per-generation/species statistics to
+    //                       the binary log PATH (see snake-telemetry)
+    //   --genealogy PATH    append every evaluated genome's ID, parents,
+    //                       mutations, species and fitness to the log PATH
+    //                       (see snake-lineage)
+    //   --novelty W         select on (1-W)*fitness + W*novelty, where novelty
+    //                       is the mean behavior distance to the K nearest
+    //                       archived/current genomes (W=1: pure novelty)
+    //   --novelty-k K       neighbours for the novelty score      (default 15)
+    //   --sweep FILE        headless: run every configuration in FILE
+    //                       concurrently and rank them (see sweep/Sweep.h)
+    //   --sweep-gens N      generations per configuration       (default 200)
+    //   --sweep-threads N   worker threads         (default: hardware threads)
+    //   --sweep-out CSV     also write the ranking to CSV
+    // ------------------------------------------------------------------------
+    std::string migrateName;
+    int migrateEvery = 10;
+    int migrantsMax  = 2;
+    std::string farmPath, workerPath;
+    int farmWorkers = 0;
+    int farmBatch   = 8;
+    bool useJit     = false;
+    bool quantized  = false;
+    bool checkQuant = false;
+    bool recurrent  = false;
+    bool pipeline   = false;
+    bool headless   = false;
+    bool checkAllocs = false;
+    bool checkActivations = false;
+    int  episodes    = 1;
+    int  maxEpisodes = 8;
+    std::string monitorName;
+    std::string exportPath;
+    std::string telemetryPath;
+    std::string genealogyPath;
+    std::string sweepPath, sweepOut;
+    float noveltyWeight = 0.0f;
+    int   noveltyK      = 15;
+    game::SensorConfig sensors;
+    sweep::SweepOptions sweepOpts;
+    sweepOpts.outputs = OUTPUT_N;
+    for (int i = 1; i < argc; ++i) {
+        auto isArg = [&](const char* name) { return std::strcmp(argv[i], name) == 0 && i + 1 < argc; };
+        if      (isArg("--migrate"))       migrateName  = argv[++i];
+        else if (isArg("--migrate-every")) migrateEvery = std::max(1, std::atoi(argv[++i]));
+        else if (isArg("--migrants"))      migrantsMax  = std::max(0, std::atoi(argv[++i]));
+        else if (isArg("--farm"))          farmPath     = argv[++i];
+        else if (isArg("--farm-workers"))  farmWorkers  = std::max(0, std::atoi(argv[++i]));
+        else if (isArg("--farm-batch"))    farmBatch    = std::max(1, std::atoi(argv[++i]));
+        else if (isArg("--worker"))        workerPath   = argv[++i];
+        else if (isArg("--telemetry"))     telemetryPath = argv[++i];
+        else if (isArg("--genealogy"))     genealogyPath = argv[++i];
+        else if (isArg("--monitor"))       monitorName  = argv[++i];
+        else if (isArg("--export"))        exportPath   = argv[++i];
+        else if (isArg("--episodes"))      episodes     = std::max(1, std::atoi(argv[++i]));
+        else if (isArg("--max-episodes"))  maxEpisodes  = std::max(1, std::atoi(argv[++i]));
+        else if (isArg("--novelty"))       noveltyWeight = std::clamp(float(std::atof(argv[++i])), 0.0f, 1.0f);
+        else if (isArg("--novelty-k"))     noveltyK     = std::max(1, std::atoi(argv[++i]));
+        else if (isArg("--sweep"))         sweepPath    = argv[++i];
+        else if (isArg("--sweep-gens"))    sweepOpts.generations = std::max(1, std::atoi(argv[++i]));
+        else if (isArg("--sweep-threads")) sweepOpts.threads     = unsigned(std::max(0, std::atoi(argv[++i])));
+        else if (isArg("--sweep-out"))     sweepOut     = argv[++i];
+        else if (isArg("--activation") || isArg("--hidden-activation") || isArg("--output-activation")) {
+            bool hidden = std::strcmp(argv[i], "--output-activation") != 0;
+            bool output = std::strcmp(argv[i], "--hidden-activation") != 0;
+            neat::Activation fn;
+            if (!neat::parseActivation(argv[++i], fn)) {
+                std::cerr << "Unknown activation " << argv[i] << "\n";
+                return 1;
+            }
+            if (hidden) neat::setActivation(neat::NodeGene::HIDDEN, fn);
+            if (output) neat::setActivation(neat::NodeGene::OUTPUT, fn);
+        }
+        else if (isArg("--sensor-patch"))  sensors.patch = std::clamp(std::atoi(argv[++i]), 0, 4);
+        else if (isArg("--sensors")) {
+            if (!game::parseRays(argv[++i], sensors)) {
+                std::cerr << "Unknown sensors " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else if (isArg("--cpu")) {
+            cpu::CpuLevel level;
+            if (!cpu::parseCpuLevel(argv[++i], level)) {
+                std::cerr << "Unknown CPU level " << argv[i] << "\n";
+                return 1;
+            }
+            if (!cpu::setCpuLevel(level)) {
+                std::cerr << "This CPU cannot run the " << argv[i] << " kernels\n";
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--jit") == 0) useJit = true;
+        else if (std::strcmp(argv[i], "--quantized") == 0) quantized = true;
+        else if (std::strcmp(argv[i], "--check-quantized") == 0) quantized = checkQuant = true;
+        else if (std::strcmp(argv[i], "--recurrent") == 0) recurrent = true;
+        else if (std::strcmp(argv[i], "--pipeline") == 0) pipeline = true;
+        else if (std::strcmp(argv[i], "--headless") == 0) headless = true;
+        else if (std::strcmp(argv[i], "--check-allocs") == 0) checkAllocs = true;
+        else if (std::strcmp(argv[i], "--check-activations") == 0) checkActivations = true;
+        else std::cerr << "Ignoring unknown argument " << argv[i] << "\n";
+    }
+    const int INPUT_N = sensors.inputs();   ///< network input size (hx, hy, fx, fy, sensors)
+    sweepOpts.sensors = sensors;
+    std::cout << "CPU kernels: " << cpu::cpuLevelName(cpu::cpuLevel())
+              << " (detected " << cpu::cpuLevelName(cpu::detectedCpuLevel()) << ")\n";
+    std::cout << "Activations: hidden " << neat::activationName(neat::activationFor(neat::NodeGene::HIDDEN))
+              << ", output " << neat::activationName(neat::activationFor(neat::NodeGene::OUTPUT)) << "\n";
+    if (checkActivations) {
+        std::cout << "Activation check:\n";
+        return neat::checkActivations(std::cout) ? 0 : 1;
+    }
+
+#ifdef SNAKENEAT_HAVE_POSIX_IPC
+    // Headless worker: no window, no population of its own
+    if (!workerPath.empty())
+        return farm::runWorker(workerPath);
+#else
+    if (!workerPath.empty() || !farmPath.empty()) {
+        std::cerr << "The evaluation farm needs Unix domain sockets; not available on this platform\n";
+        if (!workerPath.empty()) return 1;
+    }
+#endif
+
+    // Headless hyperparameter sweep
+    if (!sweepPath.empty()) {
+        std::vector<sweep::ExperimentConfig> configs;
+        if (!sweep::parseSweepFile(sweepPath, configs)) return 1;
+        auto results = sweep::runSweep(configs, sweepOpts);
+        std::cout << "\n=== Sweep ranking ===\n";
+        for (size_t i = 0; i < results.size() && i < 10; ++i)
+            std::cout << i + 1 << ". score " << results[i].score
+                      << " (" << results[i].generations << " gens)  "
+                      << results[i].config.name << "\n";
+        if (!sweepOut.empty() && !sweep::writeSweepCsv(sweepOut, results))
+            std::cerr << "Could not write " << sweepOut << "\n";
+        return 0;
+    }
+
     // ------------------------------------------------------------------------
     // Initialize core systems
     // ------------------------------------------------------------------------
-    game::Game     game(GRID_W, GRID_H, MAX_TICKS);
-    neat::NEAT     neat(POP_SIZE, INPUT_N, OUTPUT_N);
-    render::Renderer renderer(SCREEN_W, SCREEN_H, GRID_W, GRID_H);
+    if (recurrent && !farmPath.empty()) {
+        std::cerr << "Farm workers evaluate feedforward networks; --recurrent disabled with --farm\n";
+        recurrent = false;
+    }
+    if (pipeline && !farmPath.empty()) {
+        std::cerr << "The farm schedules its own evaluation; --pipeline disabled with --farm\n";
+        pipeline = false;
+    }
+    if (recurrent && (useJit || quantized))
+        std::cerr << "--recurrent evaluates with RecurrentNetwork; ignoring --jit/--quantized\n";
+    neat::NeatParams params;
+    params.allowRecurrent = recurrent;
+
+    game::Game     game(GRID_W, GRID_H, MAX_TICKS, OUTPUT_N, sensors);
+    neat::NEAT     neat(POP_SIZE, INPUT_N, OUTPUT_N, params);
+
+    std::unique_ptr<neat::NoveltyArchive> novelty;
+    if (noveltyWeight > 0.0f) {
+        novelty = std::make_unique<neat::NoveltyArchive>(game::BEHAVIOR_DIM, noveltyK);
+        neat.setNoveltyWeight(noveltyWeight);
+    }
+
+#ifdef SNAKENEAT_HAVE_POSIX_IPC
+    // Start the farm before the window exists so forked workers inherit no GL state
+    std::unique_ptr<farm::EvalFarm> evalFarm;
+    if (!farmPath.empty()) {
+        farm::EvalFarm::Options opts;
+        opts.socketPath = farmPath;
+        opts.batchSize  = farmBatch;
+        evalFarm = farm::EvalFarm::listen(opts, { GRID_W, GRID_H, MAX_TICKS, sensors.fullRays, sensors.patch, OUTPUT_N });
+        if (evalFarm && farmWorkers > 0)
+            std::cout << "Spawned " << evalFarm->spawnLocalWorkers(farmWorkers) << " local worker(s)\n";
+    }
+    // workers only report fitness, not behavior
+    if (evalFarm && novelty) {
+        std::cerr << "Novelty search needs local evaluation; disabled with --farm\n";
+        novelty.reset();
+        neat.setNoveltyWeight(0.0f);
+    }
+#endif
+
+    // Headless runs pay no rendering cost; watch them with --monitor
+    std::unique_ptr<render::Renderer> renderer;
+    if (!headless) renderer = std::make_unique<render::Renderer>(SCREEN_W, SCREEN_H, GRID_W, GRID_H);
+
+#ifdef SNAKENEAT_HAVE_POSIX_IPC
+    std::unique_ptr<neat::MigrationRing> migration;
+    if (!migrateName.empty()) {
+        migration = neat::MigrationRing::open(migrateName);
+        if (!migration) std::cerr << "Migration disabled\n";
+    }
+#else
+    if (!migrateName.empty())
+        std::cerr << "Migration needs POSIX shared memory; disabled on this platform\n";
+#endif
+
+    std::unique_ptr<telemetry::TelemetryWriter> telemetryLog;
+    if (!telemetryPath.empty())
+        telemetryLog = telemetry::TelemetryWriter::open(telemetryPath);
+    std::unique_ptr<telemetry::GenealogyWriter> genealogyLog;
+    if (!genealogyPath.empty()) {
+        genealogyLog = telemetry::GenealogyWriter::open(genealogyPath);
+        if (genealogyLog)
+            std::cout << "Genealogy: run " << genealogyLog->runId() << " -> " << genealogyPath << "\n";
+    }
+
+#ifdef SNAKENEAT_HAVE_POSIX_IPC
+    std::unique_ptr<telemetry::LivePublisher> monitor;
+    if (!monitorName.empty()) {
+        telemetry::LiveSetup setup{};
+        setup.gridW    = GRID_W;
+        setup.gridH    = GRID_H;
+        setup.maxTicks = MAX_TICKS;
+        setup.inputs   = INPUT_N;
+        setup.outputs  = OUTPUT_N;
+        setup.hiddenActivation = uint8_t(neat::activationFor(neat::NodeGene::HIDDEN));
+        setup.outputActivation = uint8_t(neat::activationFor(neat::NodeGene::OUTPUT));
+        setup.recurrent        = recurrent;
+        setup.fullRays         = sensors.fullRays;
+        setup.patch            = uint8_t(sensors.patch);
+        monitor = telemetry::LivePublisher::create(monitorName, setup);
+        if (!monitor) std::cerr << "Monitor disabled\n";
+    }
+#else
+    const bool monitor = false;
+    if (!monitorName.empty())
+        std::cerr << "The live monitor needs POSIX shared memory; disabled on this platform\n";
+#endif
+
+    using Clock = std::chrono::steady_clock;
+    auto msSince = [](Clock::time_point t0) {
+        return std::chrono::duration<float, std::milli>(Clock::now() - t0).count();
+    };
 
     // ------------------------------------------------------------------------
     // Main generational loop
     // ------------------------------------------------------------------------
-    while (!renderer.shouldClose() && neat.generation < GENERATIONS) {
+
+    // Every genome of a generation plays the same food seeds. Genes that
+    // survive unchanged (elites) keep their FitnessStats and only top them
+    // up to maxEpisodes; after that their mean is reused as is. Novelty
+    // search needs this generation's behavior, so it always plays one.
+    maxEpisodes = std::max(maxEpisodes, episodes);
+    std::random_device seedSource;
+    const uint64_t runSeed = uint64_t(seedSource()) << 32 | seedSource();
+    auto episodesFor = [&](const neat::Genome& g) {
+        int n = std::min(episodes, maxEpisodes - g.stats.episodes);
+        return std::max(n, novelty ? 1 : 0);
+    };
+    size_t episodesPlayed = 0, evaluationsReused = 0;
+
+    // Play n episodes of one genome with the network flavour picked on the
+    // command line into fresh; res holds the last one (its buffers are
+    // reused). Called from pipeline workers too: Game::evaluate keeps only
+    // per-thread scratch.
+    auto evaluateGenome = [&](const neat::Genome& g, const game::EpisodeSeeds& seeds, int n,
+                              game::EvalResult& res, neat::FitnessStats& fresh,
+                              size_t& decisions, size_t& disagreements) {
+        auto play = [&](auto&& net) {
+            for (int k = 0; k < n; ++k) {
+                game.evaluate(net, res, seeds(k));
+                fresh.add(res.fitness);
+            }
+        };
+        if (recurrent) {
+            play(neat::RecurrentNetwork(g));
+        } else if (checkQuant) {
+            neat::QuantizationCheck net(g);
+            play(net);
+            decisions     += net.decisions();
+            disagreements += net.disagreements();
+        } else if (quantized) {
+            play(neat::QuantizedNetwork(g));
+        } else if (useJit) {
+            // elites whose kernel is already compiled run natively
+            play(neat::JitNetwork(g, false));
+        } else {
+            play(neat::Network(g));
+        }
+    };
+
+    // --check-allocs: play g twice with the same network; once the buffers
+    // have grown, the second episode must not touch the heap
+    if (checkAllocs && !game::allocationsCounted()) {
+        std::cerr << "--check-allocs needs a build with -DSNAKENEAT_COUNT_ALLOCS=ON; ignoring it\n";
+        checkAllocs = false;
+    }
+    int allocFailures = 0;
+    auto episodeAllocations = [&](const neat::Genome& g) {
+        auto count = [&](auto&& net) {
+            game::EvalResult res;
+            game.evaluate(net, res);
+            size_t before = game::threadAllocations();
+            game.evaluate(net, res);
+            return game::threadAllocations() - before;
+        };
+        if (recurrent)  return count(neat::RecurrentNetwork(g));
+        if (checkQuant) return count(neat::QuantizationCheck(g));
+        if (quantized)  return count(neat::QuantizedNetwork(g));
+        if (useJit)     return count(neat::JitNetwork(g, false));
+        return count(neat::Network(g));
+    };
+
+    // With --pipeline, offspring are evaluated on a pool while the parent
+    // generation is still being bred and drawn. Each job writes only its
+    // own slot; fitness is copied into the genomes once the pool is idle.
+    struct PendingEval {
+        game::EvalResult res;
+        neat::FitnessStats fresh;
+        size_t decisions = 0, disagreements = 0;
+    };
+    std::deque<PendingEval> pending;     // by population index; never reallocates
+    std::unique_ptr<sweep::ThreadPool> pipelinePool;
+    if (pipeline) {
+        pipelinePool = std::make_unique<sweep::ThreadPool>();
+        std::cout << "Pipelined evaluation on " << pipelinePool->size() << " thread(s)\n";
+    }
+    auto submitEval = [&](size_t index, const neat::Genome& g, int generation) {
+        if (index >= pending.size()) pending.resize(index + 1);
+        PendingEval* slot = &pending[index];
+        *slot = PendingEval{};   // a migrant takes over an offspring's slot
+        game::EpisodeSeeds seeds{ runSeed, generation };
+        int n = episodesFor(g);
+        pipelinePool->submit([&evaluateGenome, slot, &g, seeds, n] {
+            evaluateGenome(g, seeds, n, slot->res, slot->fresh, slot->decisions, slot->disagreements);
+        });
+    };
+
+    // With --export: the fittest champion of any generation
+    std::unique_ptr<neat::Genome> bestEver;
+
+    // With --novelty: every genome's behavior this generation. Copied out of
+    // the evaluation results, so the reused EvalResult keeps its buffer and
+    // each slot keeps its capacity from one generation to the next.
+    std::vector<std::vector<float>> behaviors;
+
+    while ((!renderer || !renderer->shouldClose()) && neat.generation < GENERATIONS) {
         int gen = neat.generation;
 
         double totalFitness = 0.0;
         double maxFitness   = -1e9;
         int    bestIdx      = 0;
         game::EvalResult bestRes;
-
+        size_t quantDecisions = 0, quantDisagreements = 0;
+        auto phaseStart = Clock::now();
 
         // Evaluate every genome
         auto pop = neat.population();
-        for (size_t i = 0; i < pop.size(); ++i) {
-            neat::Genome* g = pop[i];
-
-            // Build network from genome
-            neat::Network net(*g);
-
-            // Run simulation and get fitness + sampled path
-            game::EvalResult res = game.evaluate(net);
-            g->fitness = res.fitness;
-            totalFitness += res.fitness;
+        const game::EpisodeSeeds seeds{ runSeed, gen };
+        if (novelty) {
+            behaviors.resize(pop.size());
+            for (auto& b : behaviors) b.reserve(game::BEHAVIOR_DIM);
+        }
+        bool bestPlayed = false;   // bestRes is the champion's own episode
+        auto record = [&](size_t i, game::EvalResult& res, const neat::FitnessStats& fresh) {
+            neat::FitnessStats& stats = pop[i]->stats;
+            if (fresh.episodes == 0) evaluationsReused++;
+            episodesPlayed += size_t(fresh.episodes);
+            stats.merge(fresh);
+            pop[i]->fitness = float(stats.mean);
+            totalFitness += stats.mean;
 
             // Track the best genome index
-            if (res.fitness > maxFitness) {
-                maxFitness = res.fitness;
+            if (stats.mean > maxFitness) {
+                maxFitness = stats.mean;
                 bestIdx    = static_cast<int>(i);
-                bestRes    = res;
+                bestPlayed = fresh.episodes > 0;
+                if (bestPlayed) bestRes = res;
+            }
+            if (novelty) behaviors[i].assign(res.behavior.begin(), res.behavior.end());
+        };
+#ifdef SNAKENEAT_HAVE_POSIX_IPC
+        if (evalFarm) {
+            // only genomes with episodes left to play are shipped
+            std::vector<neat::Genome*> toPlay;
+            std::vector<int> counts;
+            std::vector<size_t> where;
+            for (size_t i = 0; i < pop.size(); ++i) {
+                int n = episodesFor(*pop[i]);
+                if (n == 0) continue;
+                toPlay.push_back(pop[i]);
+                counts.push_back(n);
+                where.push_back(i);
+            }
+            std::vector<neat::FitnessStats> fresh;
+            evalFarm->evaluate(toPlay, counts, seeds, fresh, [&](neat::Genome& g, int n) {
+                game::EvalResult res;
+                neat::FitnessStats s;
+                neat::Network net(g);
+                for (int k = 0; k < n; ++k) {
+                    game.evaluate(net, res, seeds(k));
+                    s.add(res.fitness);
+                }
+                return s;
+            });
+            std::vector<neat::FitnessStats> played(pop.size());
+            for (size_t k = 0; k < where.size(); ++k) played[where[k]] = fresh[k];
+            game::EvalResult none;
+            for (size_t i = 0; i < pop.size(); ++i) record(i, none, played[i]);
+            // Workers only report fitness; the champion is replayed below
+            bestPlayed = false;
+        }
+        else
+#endif
+        if (pipelinePool) {
+            // Offspring were submitted while the last generation bred;
+            // only the initial population has to be queued here
+            if (pending.empty())
+                for (size_t i = 0; i < pop.size(); ++i) submitEval(i, *pop[i], gen);
+            pipelinePool->wait();
+            for (size_t i = 0; i < pop.size(); ++i) {
+                quantDecisions     += pending[i].decisions;
+                quantDisagreements += pending[i].disagreements;
+                record(i, pending[i].res, pending[i].fresh);
+            }
+            pending.clear();
+        }
+        else {
+            game::EvalResult res;   // reused by every episode
+            for (size_t i = 0; i < pop.size(); ++i) {
+                // Run simulation and get fitness + sampled path
+                neat::FitnessStats fresh;
+                evaluateGenome(*pop[i], seeds, episodesFor(*pop[i]), res, fresh,
+                               quantDecisions, quantDisagreements);
+                record(i, res, fresh);
             }
         }
 
+        // A champion that reused its running mean has no path to draw
+        if (renderer && !bestPlayed) {
+            neat::Network bestNet(*pop[bestIdx]);
+            game.evaluate(bestNet, bestRes, seeds(0));
+        }
+
+        if (checkAllocs) {
+            size_t n = episodeAllocations(*pop[bestIdx]);
+            if (n > 0) {
+                std::cerr << "Gen " << gen << ": champion episode made " << n << " heap allocation(s)\n";
+                allocFailures++;
+            }
+        }
+
+        // The champion is likely to be carried over as an elite: compile it
+        if (useJit && !recurrent)
+            neat::JitCompiler::getInstance().find(*pop[bestIdx], true);
+
+        // Novelty of every genome against the archive and each other
+        if (novelty && !behaviors.empty()) {
+            auto scores = novelty->score(behaviors);
+            for (size_t i = 0; i < pop.size(); ++i) pop[i]->novelty = scores[i];
+            novelty->update(behaviors, scores);
+        }
+
+        float evalMs = msSince(phaseStart);
+
         // Compute summary stats
         double avgFitness   = totalFitness / pop.size();
         int    speciesCount = static_cast<int>(neat.species().size());
+        if (quantDecisions > 0)
+            std::cout << "Gen " << gen << ": int8 network disagrees with float on "
+                      << 100.0 * quantDisagreements / quantDecisions << "% of "
+                      << quantDecisions << " moves\n";
 
 
         // --------------------------------------------------------------------
         // Visualization: re-evaluate best genome for path, then render a
         // single frame showing its sampled path + neural network + stats.
         // --------------------------------------------------------------------
-        {
-            neat::Genome* bestG = pop[bestIdx];
-            neat::Network bestNet(*bestG);
+        auto drawGeneration = [&](const neat::Genome& bestG) {
+            neat::Network bestNet(bestG);
 
-            renderer.beginFrame();
-            renderer.drawGrid();
+            renderer->beginFrame();
+            renderer->drawGrid();
 
             // Draw sampled head-positions (every 10 ticks) as a “snake”
-            renderer.drawSnake(bestRes.bestPath);
+            renderer->drawSnake(bestRes.bestPath);
 
 
-            renderer.drawNetwork(bestNet);
+            renderer->drawNetwork(bestNet);
 
             // Overlay generation stats on screen
-            renderer.drawStats(
+            renderer->drawStats(
                 gen,
                 static_cast<float>(maxFitness),
                 static_cast<float>(avgFitness),
                 speciesCount
             );
-            renderer.endFrame();
+            renderer->endFrame();
+        };
+        // reproduce() frees this generation; the pipeline draws after it
+        neat::Genome champion = *pop[bestIdx];
+        if (!exportPath.empty() && (!bestEver || champion.fitness > bestEver->fitness))
+            bestEver = std::make_unique<neat::Genome>(champion);
+        float renderMs = 0.0f;
+        if (renderer && !pipelinePool) {
+            phaseStart = Clock::now();
+            drawGeneration(champion);
+            renderMs = msSince(phaseStart);
+        }
+
+        // Snapshot statistics while species still point at this population
+        telemetry::GenerationRecord genStats{};
+        if (telemetryLog || monitor) {
+            genStats = telemetry::sampleGeneration(neat);
+            genStats.evalMs   = evalMs;
         }
+        if (telemetryLog) telemetry::pushSpecies(*telemetryLog, neat);
+        if (genealogyLog) telemetry::pushGenealogy(*genealogyLog, neat);
+
+#ifdef SNAKENEAT_HAVE_POSIX_IPC
+        if (monitor && !monitor->publish(genStats, neat, champion))
+            std::cerr << "Monitor: champion too large to publish\n";
+
+        // Share this generation's champion before reproduce() frees it
+        bool migrateNow = migration && (gen + 1) % migrateEvery == 0;
+        if (migrateNow && !migration->publish(champion))
+            std::cerr << "Migration: champion too large to publish\n";
+#endif
 
         // --------------------------------------------------------------------
-        // Speciate & reproduce to form the next generation
-        // We pass a no-op evalFunc since fitness is already filled.
+        // Speciate & reproduce to form the next generation. Fitness is
+        // already filled; in the pipeline every offspring starts evaluating
+        // as soon as it exists and this generation is drawn meanwhile.
         // --------------------------------------------------------------------
-        neat.epoch([](neat::Genome&){ /* already evaluated */ });
+        phaseStart = Clock::now();
+        if (pipelinePool) {
+            neat.breed([&](size_t index, const neat::Genome& g) { submitEval(index, g, gen + 1); });
+        } else {
+            neat.epoch([](neat::Genome&){ /* already evaluated */ });
+        }
+        float epochMs = msSince(phaseStart);
+        if (renderer && pipelinePool) {
+            phaseStart = Clock::now();
+            drawGeneration(champion);
+            renderMs = msSince(phaseStart);
+        }
+        if (telemetryLog) {
+            genStats.renderMs = renderMs;
+            genStats.epochMs  = epochMs;
+            telemetryLog->push(genStats);
+        }
+
+#ifdef SNAKENEAT_HAVE_POSIX_IPC
+        // Pull in elites from the other islands; they are evaluated and
+        // speciated with the rest of the next generation
+        if (migrateNow) {
+            // migrants replace genomes the pipeline may still be playing
+            if (pipelinePool) pipelinePool->wait();
+            auto before = neat.population();
+            int n = neat.immigrate(migration->collect(migrantsMax));
+            if (n > 0) std::cout << "Gen " << gen << ": imported " << n << " migrant(s)\n";
+            const auto& after = neat.population();
+            for (size_t i = 0; pipelinePool && i < after.size(); ++i)
+                if (after[i] != before[i]) submitEval(i, *after[i], neat.generation);
+        }
+#endif
+    }
+
+    // Offspring of the last generation may still be in flight
+    if (pipelinePool) {
+        pipelinePool->wait();
+        const auto& pop = neat.population();
+        for (size_t i = 0; i < pop.size() && i < pending.size(); ++i) {
+            pop[i]->stats.merge(pending[i].fresh);
+            pop[i]->fitness = float(pop[i]->stats.mean);
+        }
+    }
+
+    std::cout << "Played " << episodesPlayed << " episodes; " << evaluationsReused
+              << " evaluation(s) reused a genome's running mean\n";
+
+    if (!exportPath.empty()) {
+        const neat::Genome& g = bestEver ? *bestEver : *neat.getBest();
+        if (neat::exportChampion(g, exportPath, recurrent))
+            std::cout << "Exported champion (fitness " << g.fitness << ") to " << exportPath << "\n";
+    }
+
+    if (checkAllocs)
+        std::cout << "Allocation check: " << allocFailures << " generation(s) with allocating episodes\n";
+
+    if (!renderer) {
+        std::cout << "\n=== Training complete ===\n";
+        return allocFailures > 0 ? 1 : 0;
     }
 
     // ------------------------------------------------------------------------
@@ -117,7 +688,9 @@ int main() {
     {
         std::cout << "\n=== Training complete. Running final demonstration ===\n";
         neat::Genome* champion = neat.getBest();
-        neat::Network  net(*champion);
+        neat::JitNetwork net(*champion, !recurrent);   // interpreted until its kernel is ready
+        std::unique_ptr<neat::RecurrentNetwork> rnet;
+        if (recurrent) rnet = std::make_unique<neat::RecurrentNetwork>(*champion);
 
         // Prepare demonstration environment
         game::Snake snake(GRID_W, GRID_H);
@@ -130,27 +703,21 @@ int main() {
         auto resetSim = [&]() {
             snake.reset();
             food = { distX(rng), distY(rng) };
+            if (rnet) rnet->reset();
         };
 
         resetSim();
         SetTargetFPS(5);
+        std::vector<float> inputs;
 
 
         // Demo loop: restart on death, exit on ESC
-        while (!renderer.shouldClose()) {
+        while (!renderer->shouldClose()) {
             // 1) Get normalized inputs
-            auto head = snake.head();
-            float hx = float(head.x) / GRID_W;
-            float hy = float(head.y) / GRID_H;
-            float fx = float(food.x - head.x) / GRID_W;
-            float fy = float(food.y - head.y) / GRID_H;
-            auto ray = snake.getRayCast();
-            float left  = std::get<0>(ray);
-            float front = std::get<1>(ray);
-            float right = std::get<2>(ray);
+            game::sense(snake, food, sensors, inputs);
 
             // 2) Feed network and update direction
-            auto outputs = net.feed({ hx, hy, fx, fy, left, front, right});
+            auto outputs = rnet ? rnet->feed(inputs) : net.feed(inputs);
             // auto outputs = net.feed({hx, hy, fx, fy});
             int dir = std::distance(
                 outputs.begin(),
@@ -170,12 +737,12 @@ int main() {
             }
 
             // 4) Render game + network
-            renderer.beginFrame();
-            renderer.drawGrid();
-            renderer.drawSnake(snake.body());
-            renderer.drawFood(food.x, food.y);
-            renderer.drawNetwork(net);  // network rendering next to grid
-            renderer.endFrame();
+            renderer->beginFrame();
+            renderer->drawGrid();
+            renderer->drawSnake(snake.body());
+            renderer->drawFood(food.x, food.y);
+            renderer->drawNetwork(net.getGenome(), rnet ? rnet->getActivations() : net.getActivations());  // network next to grid
+            renderer->endFrame();
 
             // 5) Exit on ESC
             if (IsKeyPressed(KEY_ESCAPE)) {
@@ -0,0 +1,71 @@
+// Activation.cpp
+#include "Activation.h"
+#include <chrono>
+#include <cstring>
+#include <ostream>
+#include <vector>
+
+namespace neat {
+
+static const struct { const char* name; Activation fn; } ACTIVATION_NAMES[] = {
+    { "tanh",      Activation::TANH      },
+    { "fast-tanh", Activation::FAST_TANH },
+    { "lut-tanh",  Activation::LUT_TANH  },
+    { "sigmoid",   Activation::SIGMOID   },
+    { "relu",      Activation::RELU      },
+    { "linear",    Activation::LINEAR    },
+};
+
+bool parseActivation(const char* name, Activation& out) {
+    for (auto& entry : ACTIVATION_NAMES) {
+        if (std::strcmp(entry.name, name) == 0) {
+            out = entry.fn;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* activationName(Activation a) {
+    for (auto& entry : ACTIVATION_NAMES)
+        if (entry.fn == a) return entry.name;
+    return "?";
+}
+
+bool checkActivations(std::ostream& os) {
+    static const struct { Activation fn; double (*ref)(double); double bound; } CHECKS[] = {
+        { Activation::TANH,      [](double x) { return std::tanh(x); },                1e-6   },
+        { Activation::FAST_TANH, [](double x) { return std::tanh(x); },                4e-7   },
+        { Activation::LUT_TANH,  [](double x) { return std::tanh(x); },                2.4e-5 },
+        { Activation::SIGMOID,   [](double x) { return 1.0 / (1.0 + std::exp(-x)); }, 1e-6   },
+        { Activation::RELU,      [](double x) { return x > 0.0 ? x : 0.0; },          0.0    },
+    };
+    // every float in [-10, 10] at a 1/4096 step, then a timing pass over
+    // 64K of them, as networks apply them: one call per node
+    std::vector<float> xs;
+    for (int i = -10 * 4096; i <= 10 * 4096; ++i) xs.push_back(float(i) / 4096.0f);
+    const size_t TIMED = 65536, REPS = 64;
+
+    bool ok = true;
+    for (auto& c : CHECKS) {
+        double err = 0.0;
+        for (float x : xs) err = std::max(err, std::abs(double(activate(c.fn, x)) - c.ref(x)));
+
+        float sink = 0.0f;
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < REPS; ++r)
+            for (size_t i = 0; i < TIMED; ++i) sink += activate(c.fn, xs[i] + float(r) * 1e-6f);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count()
+                  / double(TIMED * REPS);
+        volatile float keep = sink;   // the timed loop must not be dropped
+        (void)keep;
+
+        bool pass = err <= c.bound;
+        ok = ok && pass;
+        os << "  " << activationName(c.fn) << ": max error " << err << " (bound " << c.bound << "), "
+           << ns << " ns/value" << (pass ? "" : "  EXCEEDS BOUND") << "\n";
+    }
+    return ok;
+}
+
+} // namespace neat
@@ -0,0 +1,103 @@
+// Activation.h
+#pragma once
+#include "Gene.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iosfwd>
+
+namespace neat {
+
+/**
+ * Node activation functions.
+ *
+ *  TANH       std::tanh
+ *  FAST_TANH  odd rational approximation (degree 13/6), clamped to ±7.905;
+ *             max abs error vs std::tanh 4e-7 over the whole real line
+ *  LUT_TANH   linear interpolation in a 1025-entry table over [-8, 8];
+ *             max abs error 2.4e-5
+ *  SIGMOID    logistic 1 / (1 + e^-x)
+ *  RELU       max(0, x)
+ *  LINEAR     identity
+ *
+ * Both tanh approximations are branch-free. checkActivations() (run with
+ * --check-activations) measures each function's error and cost per value
+ * and checks the two bounds above.
+ */
+enum class Activation { TANH, FAST_TANH, LUT_TANH, SIGMOID, RELU, LINEAR };
+
+// Compile-time default for hidden and output nodes, e.g.
+// -DSNAKENEAT_DEFAULT_ACTIVATION=FAST_TANH (see the CMake option).
+#ifndef SNAKENEAT_DEFAULT_ACTIVATION
+#define SNAKENEAT_DEFAULT_ACTIVATION TANH
+#endif
+
+// The tanh kernels are defined once through this macro so the JIT can paste
+// the very same source into generated networks (activationKernelSource()).
+#define SNAKENEAT_ACTIVATION_KERNELS(...)                                   \
+    __VA_ARGS__                                                             \
+    inline const char* activationKernelSource() { return #__VA_ARGS__; }
+
+SNAKENEAT_ACTIVATION_KERNELS(
+inline float snn_fast_tanh(float x) {
+    x = x < -7.90531110f ? -7.90531110f : (x > 7.90531110f ? 7.90531110f : x);
+    float x2 = x * x;
+    float p = -2.76076847742355e-16f;
+    p = p * x2 + 2.00018790482477e-13f;
+    p = p * x2 - 8.60467152213735e-11f;
+    p = p * x2 + 5.12229709037114e-08f;
+    p = p * x2 + 1.48572235717979e-05f;
+    p = p * x2 + 6.37261928875436e-04f;
+    p = p * x2 + 4.89352455891786e-03f;
+    float q = 1.19825839466702e-06f;
+    q = q * x2 + 1.18534705686654e-04f;
+    q = q * x2 + 2.26843463243900e-03f;
+    q = q * x2 + 4.89352518554385e-03f;
+    return x * p / q;
+}
+struct SnnTanhTable {
+    float v[1025];
+    SnnTanhTable() { for (int i = 0; i <= 1024; ++i) v[i] = std::tanh(i / 64.0f - 8.0f); }
+};
+inline float snn_lut_tanh(float x) {
+    static const SnnTanhTable table;
+    float t = (x + 8.0f) * 64.0f;
+    t = t < 0.0f ? 0.0f : (t > 1023.999f ? 1023.999f : t);
+    int i = int(t);
+    float f = t - float(i);
+    return table.v[i] + f * (table.v[i + 1] - table.v[i]);
+}
+)
+
+inline float activate(Activation a, float x) {
+    switch (a) {
+        case Activation::TANH:      return std::tanh(x);
+        case Activation::FAST_TANH: return snn_fast_tanh(x);
+        case Activation::LUT_TANH:  return snn_lut_tanh(x);
+        case Activation::SIGMOID:   return 1.0f / (1.0f + std::exp(-x));
+        case Activation::RELU:      return std::max(0.0f, x);
+        case Activation::LINEAR:    return x;
+    }
+    return x;
+}
+
+/// Runtime choice per node type (inputs and bias are never activated).
+/// Set once at startup, before networks are built.
+inline Activation nodeActivation[4] = {
+    Activation::LINEAR, Activation::LINEAR,
+    Activation::SNAKENEAT_DEFAULT_ACTIVATION, Activation::SNAKENEAT_DEFAULT_ACTIVATION,
+};
+
+inline Activation activationFor(NodeGene::Type t) { return nodeActivation[t]; }
+inline void setActivation(NodeGene::Type t, Activation a) { nodeActivation[t] = a; }
+
+/// Parse "tanh", "fast-tanh", "lut-tanh", "sigmoid", "relu" or "linear".
+bool parseActivation(const char* name, Activation& out);
+const char* activationName(Activation a);
+
+/// Print every function's max abs error against double-precision
+/// references over [-10, 10] and its ns/value through activate(); false
+/// if an approximation exceeds its documented bound.
+bool checkActivations(std::ostream& os);
+
+} // namespace neat
@@ -0,0 +1,114 @@
+// ChampionExport.cpp
+#include "ChampionExport.h"
+#include "Activation.h"
+#include "Network.h"
+#include "player/ChampionFormat.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+namespace neat {
+
+using namespace player;
+
+bool compileChampion(const Genome& g, bool recurrent, std::vector<uint8_t>& out) {
+    // dense slots in node-ID order, like every other executor
+    std::unordered_map<NodeId, uint32_t> slot;
+    std::vector<float>    init;
+    std::vector<uint32_t> inputs, outputs;
+    for (auto& kv : g.nodes) {
+        uint32_t i = uint32_t(init.size());
+        slot.emplace(kv.first, i);
+        init.push_back(kv.second.type == NodeGene::BIAS ? 1.0f : 0.0f);
+        if (kv.second.type == NodeGene::INPUT)  inputs.push_back(i);
+        if (kv.second.type == NodeGene::OUTPUT) outputs.push_back(i);
+    }
+
+    // enabled edges, keyed by the node that owns them in the program:
+    // the source when pushing, the destination when pulling
+    std::unordered_map<NodeId, std::vector<ConnectionGene>> owned;
+    for (const auto& kv : g.connections) {
+        const auto& cg = kv.second;
+        if (!cg.enabled || !slot.count(cg.from) || !slot.count(cg.to)) continue;
+        if (!std::isfinite(cg.weight)) {
+            std::cerr << "exportChampion: non-finite weight on " << cg.from << "->" << cg.to << "\n";
+            return false;
+        }
+        owned[recurrent ? cg.to : cg.from].push_back(cg);
+    }
+
+    auto activationOf = [&](NodeId id) -> uint8_t {
+        auto type = g.nodes.at(id).type;
+        if (type != NodeGene::HIDDEN && type != NodeGene::OUTPUT) return CHAMPION_ACT_NONE;
+        return uint8_t(activationFor(type));
+    };
+
+    // program order: Network's topological order, or every computed node
+    std::vector<NodeId> order;
+    if (recurrent) {
+        for (auto& kv : g.nodes)
+            if (activationOf(kv.first) != CHAMPION_ACT_NONE) order.push_back(kv.first);
+    } else {
+        order = Network(g).order();
+    }
+
+    std::vector<ChampionStep> steps;
+    std::vector<ChampionEdge> edges;
+    for (NodeId id : order) {
+        steps.push_back({ slot[id], uint32_t(edges.size()), activationOf(id), {} });
+        for (const ConnectionGene& cg : owned[id])
+            edges.push_back({ slot[recurrent ? cg.from : cg.to], cg.weight });
+    }
+    steps.push_back({ 0, uint32_t(edges.size()), CHAMPION_ACT_NONE, {} });   // sentinel
+
+    ChampionHeader h{};
+    h.magic      = CHAMPION_MAGIC;
+    h.version    = CHAMPION_VERSION;
+    h.inputs     = uint32_t(inputs.size());
+    h.outputs    = uint32_t(outputs.size());
+    h.nodes      = uint32_t(init.size());
+    h.steps      = uint32_t(steps.size() - 1);
+    h.edges      = uint32_t(edges.size());
+    h.mode       = recurrent ? PULL : PUSH;
+    h.sourceHash = g.contentHash();
+
+    uint32_t at = championAlign(sizeof(ChampionHeader));
+    auto place = [&](uint32_t& offset, size_t bytes) {
+        offset = at;
+        at = championAlign(uint32_t(at + bytes));
+    };
+    place(h.initOffset,   init.size()    * sizeof(float));
+    place(h.inputOffset,  inputs.size()  * sizeof(uint32_t));
+    place(h.outputOffset, outputs.size() * sizeof(uint32_t));
+    place(h.stepOffset,   steps.size()   * sizeof(ChampionStep));
+    place(h.edgeOffset,   edges.size()   * sizeof(ChampionEdge));
+    h.fileBytes = at;
+
+    out.assign(at, 0);
+    auto put = [&](uint32_t offset, const void* src, size_t bytes) {
+        if (bytes) std::memcpy(out.data() + offset, src, bytes);
+    };
+    put(0,              &h,             sizeof(h));
+    put(h.initOffset,   init.data(),    init.size()    * sizeof(float));
+    put(h.inputOffset,  inputs.data(),  inputs.size()  * sizeof(uint32_t));
+    put(h.outputOffset, outputs.data(), outputs.size() * sizeof(uint32_t));
+    put(h.stepOffset,   steps.data(),   steps.size()   * sizeof(ChampionStep));
+    put(h.edgeOffset,   edges.data(),   edges.size()   * sizeof(ChampionEdge));
+    return true;
+}
+
+bool exportChampion(const Genome& g, const std::string& path, bool recurrent) {
+    std::vector<uint8_t> buf;
+    if (!compileChampion(g, recurrent, buf)) return false;
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(reinterpret_cast<const char*>(buf.data()), std::streamsize(buf.size()));
+    if (!f) {
+        std::cerr << "Could not write champion to " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace neat
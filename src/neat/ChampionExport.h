@@ -0,0 +1,25 @@
+// ChampionExport.h
+#pragma once
+#include "Genome.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace neat {
+
+/**
+ * @brief  Compile a genome into the standalone player format
+ *         (player/ChampionFormat.h).
+ *
+ * The topology is flattened once here (dense slots, evaluation order,
+ * activation per step, contiguous edge lists) so that the player only
+ * maps the file and runs it. Feedforward champions reproduce
+ * Network::feed bit for bit; with recurrent=true the program follows
+ * RecurrentNetwork instead. Activations are the ones configured now.
+ */
+bool compileChampion(const Genome& g, bool recurrent, std::vector<uint8_t>& out);
+
+/// compileChampion() into a file. False (with a message) on failure.
+bool exportChampion(const Genome& g, const std::string& path, bool recurrent = false);
+
+} // namespace neat
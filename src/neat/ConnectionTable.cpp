@@ -0,0 +1,89 @@
+// ConnectionTable.cpp
+#include "ConnectionTable.h"
+#include <algorithm>
+
+namespace neat {
+
+ConnectionTable::ConnectionTable(std::shared_ptr<const Topology> t)
+    : topo_(std::move(t)), weights_(topo_->size(), 0.0f), enabled_(topo_->size(), 0) {}
+
+ConnectionTable ConnectionTable::fromGenes(std::vector<ConnectionGene> genes) {
+    ConnectionTable t;
+    t.insert(genes.data(), genes.size());
+    return t;
+}
+
+void ConnectionTable::insert(const ConnectionGene* genes, size_t n) {
+    // genes already present only change this genome's arrays
+    std::vector<ConnectionGene> added;
+    for (size_t k = 0; k < n; ++k) {
+        const ConnectionGene& g = genes[k];
+        size_t i = topo_->find(g.innov);
+        if (i != size() && from(i) == g.from && to(i) == g.to) {
+            weights_[i] = g.weight;
+            enabled_[i] = g.enabled;
+        } else {
+            added.push_back(g);
+        }
+    }
+    if (added.empty()) return;
+
+    // in innovation order, the last of equal innovations winning
+    std::stable_sort(added.begin(), added.end(),
+                     [](const ConnectionGene& a, const ConnectionGene& b) { return a.innov < b.innov; });
+    size_t kept = 0;
+    for (size_t k = 0; k < added.size(); ++k) {
+        if (k + 1 < added.size() && added[k + 1].innov == added[k].innov) continue;
+        added[kept++] = added[k];
+    }
+    added.resize(kept);
+
+    // the new structure: runs of the old genes copied whole, the added
+    // ones spliced in between
+    const Topology& old = *topo_;
+    Topology t;
+    std::vector<float>   w;
+    std::vector<uint8_t> on;
+    size_t total = size() + added.size();
+    t.innov.reserve(total);
+    t.from.reserve(total);
+    t.to.reserve(total);
+    w.reserve(total);
+    on.reserve(total);
+    t.hash = old.hash;
+    auto copyRun = [&](size_t first, size_t last) {
+        t.innov.insert(t.innov.end(), old.innov.begin() + first, old.innov.begin() + last);
+        t.from.insert(t.from.end(), old.from.begin() + first, old.from.begin() + last);
+        t.to.insert(t.to.end(), old.to.begin() + first, old.to.begin() + last);
+        w.insert(w.end(), weights_.begin() + first, weights_.begin() + last);
+        on.insert(on.end(), enabled_.begin() + first, enabled_.begin() + last);
+    };
+    size_t i = 0;
+    for (const ConnectionGene& g : added) {
+        size_t at = size_t(std::lower_bound(old.innov.begin() + i, old.innov.end(), g.innov)
+                           - old.innov.begin());
+        copyRun(i, at);
+        i = at;
+        if (i < size() && innov(i) == g.innov) {               // new endpoints replace it
+            t.hash -= Topology::geneHash(innov(i), from(i), to(i));
+            ++i;
+        }
+        t.innov.push_back(g.innov);
+        t.from.push_back(g.from);
+        t.to.push_back(g.to);
+        w.push_back(g.weight);
+        on.push_back(g.enabled);
+        t.hash += Topology::geneHash(g.innov, g.from, g.to);
+    }
+    copyRun(i, size());
+
+    topo_ = TopologyPool::getInstance().intern(std::move(t));
+    weights_.swap(w);
+    enabled_.swap(on);
+}
+
+size_t ConnectionTable::bytes() const {
+    return sizeof(*this) + weights_.capacity() * sizeof(float) + enabled_.capacity();
+}
+
+} // namespace neat
@@ -0,0 +1,113 @@
+// ConnectionTable.h
+#pragma once
+#include "Gene.h"
+#include "Topology.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace neat {
+
+/**
+ * @brief  A genome's connection genes: an interned Topology plus the
+ *         genome's own weights and enabled flags, parallel to it.
+ *
+ * Weight and enable changes write only the genome's arrays; adding genes
+ * interns a new topology, so genomes with one structure share one object
+ * and copying a table is a reference bump and two flat array copies.
+ * Reads look like the std::map this replaces: iteration is in innovation
+ * order and yields (innovation, ConnectionGene) pairs by value, so keep
+ * copies rather than pointers into it.
+ */
+class ConnectionTable {
+public:
+    using value_type = std::pair<InnovId, ConnectionGene>;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = ConnectionTable::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const value_type*;
+        using reference         = value_type;
+
+        struct Arrow {
+            value_type v;
+            const value_type* operator->() const { return &v; }
+        };
+
+        const_iterator() = default;
+        const_iterator(const ConnectionTable* t, size_t i) : t_(t), i_(i) {}
+
+        value_type operator*() const { return { t_->innov(i_), t_->gene(i_) }; }
+        Arrow operator->() const { return { **this }; }
+        const_iterator& operator++() { ++i_; return *this; }
+        const_iterator& operator--() { --i_; return *this; }
+        const_iterator operator++(int) { const_iterator c = *this; ++i_; return c; }
+        const_iterator operator--(int) { const_iterator c = *this; --i_; return c; }
+        bool operator==(const const_iterator& o) const { return i_ == o.i_; }
+        bool operator!=(const const_iterator& o) const { return i_ != o.i_; }
+        /// Position in the table.
+        size_t index() const { return i_; }
+
+    private:
+        const ConnectionTable* t_ = nullptr;
+        size_t i_ = 0;
+    };
+    using iterator = const_iterator;
+
+    ConnectionTable() : topo_(TopologyPool::empty()) {}
+
+    /// Genes of topology t, all disabled with weight 0 until set.
+    explicit ConnectionTable(std::shared_ptr<const Topology> t);
+
+    /// Table of genes given in any order; of several genes with one
+    /// innovation number, the last one wins.
+    static ConnectionTable fromGenes(std::vector<ConnectionGene> genes);
+
+    // ---- reads ------------------------------------------------------------
+    size_t size()  const { return weights_.size(); }
+    bool   empty() const { return weights_.empty(); }
+    const_iterator begin() const { return { this, 0 }; }
+    const_iterator end()   const { return { this, size() }; }
+    const_iterator find(InnovId k) const { return { this, topo_->find(k) }; }
+    size_t count(InnovId k) const { return topo_->find(k) != size(); }
+
+    // by position, in innovation order
+    InnovId innov(size_t i)   const { return topo_->innov[i]; }
+    NodeId  from(size_t i)    const { return topo_->from[i]; }
+    NodeId  to(size_t i)      const { return topo_->to[i]; }
+    float   weight(size_t i)  const { return weights_[i]; }
+    bool    enabled(size_t i) const { return enabled_[i] != 0; }
+    ConnectionGene gene(size_t i) const {
+        return { innov(i), from(i), to(i), weight(i), enabled(i) };
+    }
+
+    const std::shared_ptr<const Topology>& topology() const { return topo_; }
+    const float* weights() const { return weights_.data(); }
+    /// Bytes owned by this table (the shared topology not included).
+    size_t bytes() const;
+
+    // ---- writes -----------------------------------------------------------
+    float* weights() { return weights_.data(); }
+    void setWeight(size_t i, float w)   { weights_[i] = w; }
+    void setEnabled(size_t i, bool on)  { enabled_[i] = on; }
+
+    /// Add genes (or, for an innovation already present with the same
+    /// endpoints, overwrite its weight and flag). A structural change
+    /// interns one new topology for all of them.
+    void insert(const ConnectionGene* genes, size_t n);
+    void insert(const ConnectionGene& g) { insert(&g, 1); }
+
+    void clear() { *this = ConnectionTable(); }
+
+private:
+    std::shared_ptr<const Topology> topo_;
+    std::vector<float>   weights_;   // parallel to topo_->innov
+    std::vector<uint8_t> enabled_;
+};
+
+} // namespace neat
@@ -0,0 +1,95 @@
+// CowMap.h
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
+
+namespace neat {
+
+/**
+ * @brief  Ordered map with copy-on-write storage, for a genome's node table.
+ *
+ * Copying a CowMap shares the underlying std::map; the first write
+ * through a copy whose storage is shared clones it. Reads never copy, so
+ * iteration only hands out const iterators: mutate through operator[],
+ * emplace_hint() or edit(). Elites and crossover children therefore share
+ * their parent's nodes until a mutation adds one.
+ *
+ * Writers need exclusive access to *this CowMap* only (as with std::map);
+ * other copies sharing its storage may be read or written concurrently.
+ */
+template<typename K, typename V>
+class CowMap {
+public:
+    using map_type       = std::map<K, V>;
+    using key_type       = K;
+    using mapped_type    = V;
+    using value_type     = typename map_type::value_type;
+    using const_iterator = typename map_type::const_iterator;
+    using iterator       = const_iterator;
+    using const_reverse_iterator = typename map_type::const_reverse_iterator;
+
+    CowMap() = default;
+
+    // ---- reads (shared storage) -------------------------------------------
+    const map_type& get() const { return p_ ? *p_ : none(); }
+    const_iterator begin() const { return get().begin(); }
+    const_iterator end()   const { return get().end(); }
+    const_reverse_iterator rbegin() const { return get().rbegin(); }
+    const_reverse_iterator rend()   const { return get().rend(); }
+    size_t size()  const { return get().size(); }
+    bool   empty() const { return get().empty(); }
+    size_t count(const K& k) const { return get().count(k); }
+    const_iterator find(const K& k) const { return get().find(k); }
+    const V& at(const K& k) const { return get().at(k); }
+
+    /// True if another CowMap holds the same storage.
+    bool shared() const { return p_ && p_.use_count() > 1; }
+
+    /// Changes on every write (unique across all maps); a copy carries
+    /// it until either side writes. 0 for a map never written.
+    uint64_t stamp() const { return stamp_; }
+
+    // ---- writes (clone shared storage first) ------------------------------
+    map_type& edit() {
+        if (!p_) {
+            p_ = std::make_shared<map_type>();
+        } else if (p_.use_count() > 1) {
+            p_ = std::make_shared<map_type>(*p_);
+        } else {
+            // sole owner: order our writes after the other owners' last reads
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        stamp_ = nextStamp();
+        return *p_;
+    }
+    V& operator[](const K& k) { return edit()[k]; }
+
+    /// hint is only honoured if the storage was not shared
+    template<typename... Args>
+    const_iterator emplace_hint(const_iterator hint, Args&&... args) {
+        bool own = p_ && p_.use_count() == 1;
+        map_type& m = edit();
+        return m.emplace_hint(own ? hint : m.cend(), std::forward<Args>(args)...);
+    }
+    void clear() {
+        p_.reset();
+        stamp_ = 0;
+    }
+
+private:
+    static uint64_t nextStamp() {
+        static std::atomic<uint64_t> next{0};
+        return next.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+    static const map_type& none() {
+        static const map_type table;
+        return table;
+    }
+    std::shared_ptr<map_type> p_;
+    uint64_t stamp_ = 0;
+};
+
+} // namespace neat
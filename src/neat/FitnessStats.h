@@ -0,0 +1,39 @@
+// FitnessStats.h
+#pragma once
+
+namespace neat {
+
+/**
+ * @brief  Running mean and variance of the fitness a genome's genes have
+ *         scored, over every episode they played.
+ *
+ * Episodes are folded in one at a time (Welford) or as a batch played
+ * elsewhere (Chan et al.'s pairwise update), so a worker can return its
+ * episodes' statistics and the trainer merge them into what the genome
+ * already holds.
+ */
+struct FitnessStats {
+    int    episodes = 0;
+    double mean     = 0.0;
+    double m2       = 0.0;   // sum of squared deviations from the mean
+
+    void add(double fitness) {
+        episodes++;
+        double d = fitness - mean;
+        mean += d / episodes;
+        m2   += d * (fitness - mean);
+    }
+    void merge(const FitnessStats& o) {
+        if (o.episodes == 0) return;
+        if (episodes == 0) { *this = o; return; }
+        int    n = episodes + o.episodes;
+        double d = o.mean - mean;
+        mean += d * o.episodes / n;
+        m2   += o.m2 + d * d * double(episodes) * o.episodes / n;
+        episodes = n;
+    }
+    /// Sample variance; 0 until two episodes were played.
+    double variance() const { return episodes > 1 ? m2 / (episodes - 1) : 0.0; }
+};
+
+} // namespace neat
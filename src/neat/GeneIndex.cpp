@@ -0,0 +1,174 @@
+// GeneIndex.cpp
+#include "GeneIndex.h"
+#include "Genome.h"
+#include <algorithm>
+
+namespace neat {
+
+// Scratch for the searches, per thread so concurrent breeders never share
+// it. A node is visited if seen[slot] == epoch, so nothing is cleared.
+namespace {
+struct Scratch {
+    std::vector<uint32_t> seen, stack, fwd, bwd, pool;
+    uint32_t epoch = 0;
+
+    uint32_t begin(size_t n) {
+        if (seen.size() < n) seen.resize(n, 0);
+        if (++epoch == 0) {                       // wrapped: forget old marks
+            std::fill(seen.begin(), seen.end(), 0);
+            epoch = 1;
+        }
+        stack.clear();
+        return epoch;
+    }
+};
+thread_local Scratch scratch;
+}
+
+std::shared_ptr<GeneIndex> GeneIndex::build(const Genome& g) {
+    auto ix = std::make_shared<GeneIndex>();
+    size_t n = g.nodes.size();
+    ix->ids.reserve(n);
+    ix->lookup.reserve(n);
+    for (auto& kv : g.nodes)
+        ix->addNode(kv.first, kv.second.type != NodeGene::INPUT && kv.second.type != NodeGene::BIAS);
+
+    // edges first, then one Kahn pass for the order
+    std::vector<uint32_t> indeg(n, 0);
+    for (size_t i = 0; i < g.connections.size(); ++i) {
+        uint32_t a = ix->slot(g.connections.from(i)), b = ix->slot(g.connections.to(i));
+        if (a == NONE || b == NONE) continue;             // inconsistent genome
+        uint32_t e = uint32_t(ix->from.size());
+        ix->from.push_back(a);
+        ix->to.push_back(b);
+        ix->nextOut.push_back(ix->firstOut[a]);
+        ix->nextIn.push_back(ix->firstIn[b]);
+        ix->firstOut[a] = ix->firstIn[b] = e;
+        indeg[b]++;
+    }
+
+    std::vector<uint32_t> queue;
+    queue.reserve(n);
+    for (uint32_t s = 0; s < n; ++s)
+        if (indeg[s] == 0) queue.push_back(s);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        uint32_t s = queue[head];
+        ix->order[s] = uint32_t(head);
+        for (uint32_t e = ix->firstOut[s]; e != NONE; e = ix->nextOut[e])
+            if (--indeg[ix->to[e]] == 0) queue.push_back(ix->to[e]);
+    }
+    ix->acyclic = queue.size() == n;
+    ix->stamp(g);
+    return ix;
+}
+
+bool GeneIndex::matches(const Genome& g) const {
+    return topology == g.connections.topology() && nodesStamp == g.nodes.stamp();
+}
+
+void GeneIndex::stamp(const Genome& g) {
+    topology   = g.connections.topology();
+    nodesStamp = g.nodes.stamp();
+}
+
+uint32_t GeneIndex::slot(NodeId id) const {
+    auto it = std::lower_bound(lookup.begin(), lookup.end(), std::make_pair(id, uint32_t(0)));
+    return it != lookup.end() && it->first == id ? it->second : NONE;
+}
+
+uint32_t GeneIndex::addNode(NodeId id, bool receives) {
+    uint32_t s = uint32_t(ids.size());
+    ids.push_back(id);
+    canReceive.push_back(receives);
+    if (receives) receivers.push_back(s);
+    order.push_back(s);               // last: it has no edges yet
+    firstOut.push_back(NONE);
+    firstIn.push_back(NONE);
+    auto pos = std::make_pair(id, s);
+    lookup.insert(std::upper_bound(lookup.begin(), lookup.end(), pos), pos);
+    return s;
+}
+
+void GeneIndex::addEdge(uint32_t a, uint32_t b) {
+    uint32_t e = uint32_t(from.size());
+    from.push_back(a);
+    to.push_back(b);
+    nextOut.push_back(firstOut[a]);
+    nextIn.push_back(firstIn[b]);
+    firstOut[a] = firstIn[b] = e;
+    if (!acyclic || order[a] < order[b]) return;
+    if (a == b) { acyclic = false; return; }
+
+    // Pearce & Kelly: only the nodes b reaches and the nodes reaching a,
+    // within [order[b], order[a]], move; they swap their positions so all
+    // of a's side comes first.
+    const uint32_t lb = order[b], ub = order[a];
+    Scratch& sc = scratch;
+    uint32_t mark = sc.begin(size());
+    sc.fwd.clear();
+    sc.stack.push_back(b);
+    sc.seen[b] = mark;
+    while (!sc.stack.empty()) {
+        uint32_t x = sc.stack.back();
+        sc.stack.pop_back();
+        sc.fwd.push_back(x);
+        for (uint32_t k = firstOut[x]; k != NONE; k = nextOut[k]) {
+            uint32_t y = to[k];
+            if (y == a) { acyclic = false; return; }        // closed a cycle
+            if (sc.seen[y] != mark && order[y] < ub) { sc.seen[y] = mark; sc.stack.push_back(y); }
+        }
+    }
+    sc.bwd.clear();
+    sc.stack.push_back(a);
+    sc.seen[a] = mark;
+    while (!sc.stack.empty()) {
+        uint32_t x = sc.stack.back();
+        sc.stack.pop_back();
+        sc.bwd.push_back(x);
+        for (uint32_t k = firstIn[x]; k != NONE; k = nextIn[k]) {
+            uint32_t y = from[k];
+            if (sc.seen[y] != mark && order[y] > lb) { sc.seen[y] = mark; sc.stack.push_back(y); }
+        }
+    }
+
+    auto byOrder = [&](uint32_t x, uint32_t y) { return order[x] < order[y]; };
+    std::sort(sc.fwd.begin(), sc.fwd.end(), byOrder);
+    std::sort(sc.bwd.begin(), sc.bwd.end(), byOrder);
+    sc.pool.clear();
+    for (uint32_t x : sc.bwd) sc.pool.push_back(order[x]);
+    for (uint32_t x : sc.fwd) sc.pool.push_back(order[x]);
+    std::sort(sc.pool.begin(), sc.pool.end());
+    size_t i = 0;
+    for (uint32_t x : sc.bwd) order[x] = sc.pool[i++];
+    for (uint32_t x : sc.fwd) order[x] = sc.pool[i++];
+}
+
+bool GeneIndex::connected(uint32_t a, uint32_t b) const {
+    for (uint32_t e = firstOut[a]; e != NONE; e = nextOut[e])
+        if (to[e] == b) return true;
+    return false;
+}
+
+bool GeneIndex::reaches(uint32_t a, uint32_t b) const {
+    if (a == b) return true;
+    if (acyclic && order[a] > order[b]) return false;
+    Scratch& sc = scratch;
+    uint32_t mark = sc.begin(size());
+    sc.stack.push_back(a);
+    sc.seen[a] = mark;
+    while (!sc.stack.empty()) {
+        uint32_t x = sc.stack.back();
+        sc.stack.pop_back();
+        for (uint32_t e = firstOut[x]; e != NONE; e = nextOut[e]) {
+            uint32_t y = to[e];
+            if (y == b) return true;
+            // past b in the order nothing can lead back to it
+            if (sc.seen[y] == mark || (acyclic && order[y] > order[b])) continue;
+            sc.seen[y] = mark;
+            sc.stack.push_back(y);
+        }
+    }
+    return false;
+}
+
+} // namespace neat
@@ -0,0 +1,66 @@
+// GeneIndex.h
+#pragma once
+#include "Gene.h"
+#include "Topology.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace neat {
+
+struct Genome;
+
+/**
+ * @brief  Adjacency and topological order of a genome's structure, kept up
+ *         to date by the structural mutations.
+ *
+ * Nodes get dense slots in the order they were added; edges (enabled or
+ * not: crossover can switch them back on) are kept in per-node linked
+ * lists over flat arrays, so a copy is a handful of memcpys. While the
+ * genome is acyclic, `order` is a topological order maintained across
+ * insertions (Pearce & Kelly), so a cycle check only visits the nodes
+ * between the two endpoints and a duplicate check only the source's
+ * out-edges.
+ *
+ * Crossover children have their fitter parent's structure and share its
+ * index; like the node table it is copied before it is written.
+ */
+struct GeneIndex {
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    std::vector<NodeId>   ids;          // by slot
+    std::vector<uint8_t>  canReceive;   // not an input or the bias, by slot
+    std::vector<uint32_t> receivers;    // slots with canReceive
+    std::vector<uint32_t> order;        // topological position, by slot
+    std::vector<std::pair<NodeId, uint32_t>> lookup;   // (id, slot), by id
+    std::vector<uint32_t> firstOut, firstIn;           // by slot
+    std::vector<uint32_t> from, to, nextOut, nextIn;   // by edge
+    bool acyclic = true;      // order is valid
+    // the structure described: connection topology and node table stamp
+    std::shared_ptr<const Topology> topology;
+    uint64_t nodesStamp = 0;
+
+    static std::shared_ptr<GeneIndex> build(const Genome& g);
+
+    /// Whether this index describes g's current structure. Any write to
+    /// g's nodes, or any change to its topology, makes it stale.
+    bool matches(const Genome& g) const;
+    /// Mark the index as describing g, after bringing it in step.
+    void stamp(const Genome& g);
+
+    size_t size() const { return ids.size(); }
+    uint32_t slot(NodeId id) const;
+
+    uint32_t addNode(NodeId id, bool receives);
+    /// Record a new gene a -> b; an edge that closes a cycle clears acyclic.
+    void addEdge(uint32_t a, uint32_t b);
+
+    /// An edge a -> b exists.
+    bool connected(uint32_t a, uint32_t b) const;
+    /// A path leads from a to b (a reaches itself).
+    bool reaches(uint32_t a, uint32_t b) const;
+};
+
+} // namespace neat
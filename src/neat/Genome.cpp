@@ -1,53 +1,117 @@
 // Genome.cpp
 #include "Genome.h"
+#include "GeneIndex.h"
 #include "InnovationTracker.h"
 #include "NeatConfig.h"
 #include <random>
 #include <algorithm>
-#include <set>
+#include <atomic>
 #include <iostream>
+#include <cstring>
 
 namespace neat {
 
-static std::mt19937 rng{std::random_device{}()};
-static std::uniform_real_distribution<float> uni(-1.0f,1.0f);
+// per thread, so several NEAT instances can breed concurrently
+static thread_local std::mt19937 rng{std::random_device{}()};
+static thread_local std::uniform_real_distribution<float> uni(-1.0f,1.0f);
 
-void Genome::mutateWeights() {
-    static std::normal_distribution<float> perturbDist(0.0f, PERTURB_STRENGTH);
-    for (auto& kv : connections) {
+void Genome::mutateWeights(const NeatParams& params) {
+    std::normal_distribution<float> perturbDist(0.0f, params.perturbStrength);
+    stats = FitnessStats();
+    float* w = connections.weights();
+    for (size_t i = 0, n = connections.size(); i < n; ++i) {
         float r = uni(rng);
-        if (r < WEIGHT_PERTURB_PROB) {
+        if (r < params.weightPerturbProb) {
             // tweak existing weight
-            kv.second.weight += perturbDist(rng);
+            w[i] += perturbDist(rng);
         } else {
             // assign new weight
-            kv.second.weight  = uni(rng);
+            w[i]  = uni(rng);
         }
     }
 }
 
-void Genome::mutateAddConnection() {
-    // gather all node IDs
-    std::vector<NodeId> ids;
-    ids.reserve(nodes.size());
-    for (auto& kv : nodes) ids.push_back(kv.first);
-
-    std::uniform_int_distribution<size_t> di(0, ids.size()-1);
-    for (int tries = 0; tries < 10; ++tries) {
-        NodeId a = ids[di(rng)], b = ids[di(rng)];
-        if (a == b) continue;
-        // never connect *into* an input
-        if (nodes[b].type == NodeGene::INPUT || nodes[b].type == NodeGene::BIAS) continue;
-        // skip existing
-        bool exists = false;
-        for (auto& ck : connections)
-            if (ck.second.from == a && ck.second.to == b) { exists = true; break; }
-        if (exists) continue;
-
-        InnovId innov = InnovationTracker::getInstance().getConnectionInnov(a, b);
-        connections[innov] = { innov, a, b, uni(rng), true };
-        return;
+// g's index, built if it has none in step with its tables and copied if
+// another genome shares it, ready to be written
+static GeneIndex& editIndex(Genome& g) {
+    auto& ix = g.geneIndex;
+    if (!ix || !ix->matches(g)) {
+        ix = GeneIndex::build(g);
+    } else if (ix.use_count() > 1) {
+        ix = std::make_shared<GeneIndex>(*ix);
+    } else {
+        // sole owner: order our writes after the other owners' last reads
+        std::atomic_thread_fence(std::memory_order_acquire);
     }
+    return *ix;
+}
+
+// Exhaustive search for a valid pair, for genomes where random draws keep
+// missing: a random source with any valid target, then one of those.
+static bool findFreePair(const GeneIndex& ix, bool allowRecurrent, uint32_t& a, uint32_t& b) {
+    size_t n = ix.size();
+    std::vector<uint32_t> sources(n);
+    for (uint32_t i = 0; i < n; ++i) sources[i] = i;
+    std::shuffle(sources.begin(), sources.end(), rng);
+
+    std::vector<uint8_t>  blocked(n);
+    std::vector<uint32_t> stack, targets;
+    for (uint32_t s : sources) {
+        std::fill(blocked.begin(), blocked.end(), 0);
+        if (!allowRecurrent) {
+            blocked[s] = 1;
+            stack.assign(1, s);
+        }
+        while (!stack.empty()) {                 // s and all its ancestors
+            uint32_t x = stack.back();
+            stack.pop_back();
+            for (uint32_t e = ix.firstIn[x]; e != GeneIndex::NONE; e = ix.nextIn[e])
+                if (!blocked[ix.from[e]]) { blocked[ix.from[e]] = 1; stack.push_back(ix.from[e]); }
+        }
+        for (uint32_t e = ix.firstOut[s]; e != GeneIndex::NONE; e = ix.nextOut[e]) blocked[ix.to[e]] = 1;
+
+        targets.clear();
+        for (uint32_t t : ix.receivers)
+            if (!blocked[t]) targets.push_back(t);
+        if (targets.empty()) continue;
+        a = s;
+        b = targets[std::uniform_int_distribution<size_t>(0, targets.size() - 1)(rng)];
+        return true;
+    }
+    return false;
+}
+
+void Genome::mutateAddConnection(const NeatParams& params) {
+    if (!geneIndex || !geneIndex->matches(*this)) geneIndex = GeneIndex::build(*this);
+    const GeneIndex& ix = *geneIndex;
+    if (ix.receivers.empty()) return;
+
+    // A pair (a, b) is invalid if b is an input/bias, a -> b exists, or
+    // (unless recurrence is allowed) b reaches a: the new edge would close
+    // a cycle that Network drops. Recurrent mode allows self-loops too.
+    // Drawing pairs until one is valid picks uniformly among the valid
+    // ones, and each check only walks a's out-edges and the nodes between
+    // b and a in the topological order.
+    constexpr int DRAWS = 32;
+    std::uniform_int_distribution<size_t> pickSource(0, ix.size() - 1);
+    std::uniform_int_distribution<size_t> pickTarget(0, ix.receivers.size() - 1);
+    uint32_t a = GeneIndex::NONE, b = GeneIndex::NONE;
+    for (int k = 0; k < DRAWS && a == GeneIndex::NONE; ++k) {
+        uint32_t s = uint32_t(pickSource(rng)), t = ix.receivers[pickTarget(rng)];
+        if (ix.connected(s, t)) continue;
+        if (!params.allowRecurrent && ix.reaches(t, s)) continue;
+        a = s;
+        b = t;
+    }
+    if (a == GeneIndex::NONE && !findFreePair(ix, params.allowRecurrent, a, b)) return;
+
+    NodeId from = ix.ids[a], to = ix.ids[b];
+    InnovId innov = InnovationTracker::getInstance().getConnectionInnov(from, to);
+    GeneIndex& own = editIndex(*this);
+    own.addEdge(a, b);
+    connections.insert({ innov, from, to, uni(rng), true });
+    own.stamp(*this);
+    stats = FitnessStats();
 }
 
 
@@ -55,23 +119,42 @@ void Genome::mutateAddNode() {
     if (connections.empty()) return;
 
     // pick a random enabled connection
-    auto it = connections.begin();
-    std::advance(it, std::uniform_int_distribution<size_t>(0, connections.size()-1)(rng));
-    ConnectionGene cg = it->second;
+    size_t pick = std::uniform_int_distribution<size_t>(0, connections.size()-1)(rng);
+    ConnectionGene cg = connections.gene(pick);
     if (!cg.enabled) return;
 
+    // keep an index this genome already has in step
+    GeneIndex* ix = geneIndex && geneIndex->matches(*this) ? &editIndex(*this) : nullptr;
+
     // disable the old link
-    connections[cg.innov].enabled = false;
+    connections.setEnabled(pick, false);
+    stats = FitnessStats();
 
-    // fetch or create the new hidden node ID
+    // fetch or create the new hidden node ID (crossover may have switched
+    // the link back on after this genome split it once already)
     NodeId newId = InnovationTracker::getInstance().getSplitNodeId(cg.innov);
+    bool newNode = nodes.count(newId) == 0;
     nodes[newId] = { newId, NodeGene::HIDDEN };
 
     // create two new connections: from→new, new→to
     InnovId in1 = InnovationTracker::getInstance().getConnectionInnov(cg.from, newId);
     InnovId in2 = InnovationTracker::getInstance().getConnectionInnov(newId,   cg.to);
-    connections[in1] = { in1, cg.from, newId,   1.0f,      true };
-    connections[in2] = { in2,   newId,   cg.to,   cg.weight, true };
+    bool new1 = connections.count(in1) == 0, new2 = connections.count(in2) == 0;
+    const ConnectionGene split[2] = { { in1, cg.from, newId,   1.0f,      true },
+                                      { in2,   newId,   cg.to,   cg.weight, true } };
+    connections.insert(split, 2);
+
+    if (ix) {
+        uint32_t f = ix->slot(cg.from), t = ix->slot(cg.to);
+        if (f == GeneIndex::NONE || t == GeneIndex::NONE) {
+            geneIndex.reset();                   // inconsistent genome
+        } else {
+            uint32_t s = newNode ? ix->addNode(newId, true) : ix->slot(newId);
+            if (new1) ix->addEdge(f, s);
+            if (new2) ix->addEdge(s, t);
+            ix->stamp(*this);
+        }
+    }
 }
 
 
@@ -86,40 +169,65 @@ Genome Genome::crossover(const Genome& g1, const Genome& g2) {
     }
 
     Genome child;
-    // 1) copy all node genes from fitter parent
+    // 1) share all node genes with the fitter parent (copied on write);
+    //    the child has exactly its structure, so its index too
     child.nodes = fit->nodes;
-
-    // 2) gather all innovation IDs
-    std::set<InnovId> allInnov;
-    for (auto& kv : fit->connections) allInnov.insert(kv.first);
-    for (auto& kv : oth->connections) allInnov.insert(kv.first);
+    child.geneIndex = fit->geneIndex;
 
     std::uniform_real_distribution<float> coin(0.0f, 1.0f);
 
-    // 3) for each gene ID, decide inheritance
-    for (InnovId innov : allInnov) {
-        auto itF = fit->connections.find(innov);
-        auto itO = oth->connections.find(innov);
-
-        if (itF != fit->connections.end() && itO != oth->connections.end()) {
-            // matching gene: pick randomly
-            const ConnectionGene *src =
-                (coin(rng) < 0.5f ? &itF->second : &itO->second);
-            child.connections[innov] = *src;
-
-            // handle disabled → re-enable chance
-            if (!itF->second.enabled || !itO->second.enabled) {
-                bool enable = (coin(rng) < PROB_REENABLE_GENE);
-                child.connections[innov].enabled = true;
-            }
-
-        } else if (itF != fit->connections.end()) {
-            // disjoint or excess from fitter parent
-            child.connections[innov] = itF->second;
+    // 2) the child has every gene of the fitter parent, so its topology
+    //    too; walk both parents' genes in innovation order and decide the
+    //    weights of the matching ones
+    const ConnectionTable& F = fit->connections;
+    const ConnectionTable& O = oth->connections;
+    child.connections = F;
+    for (size_t i = 0, j = 0, nO = O.size(); i < F.size(); ++i) {
+        while (j < nO && O.innov(j) < F.innov(i)) ++j;        // only in less-fit parent → skip
+        if (j == nO || O.innov(j) != F.innov(i)) continue;    // disjoint or excess: as in fit
+
+        // matching gene: pick randomly
+        if (coin(rng) >= 0.5f) child.connections.setWeight(i, O.weight(j));
+
+        // handle disabled → re-enable chance
+        if (!F.enabled(i) || !O.enabled(j)) {
+            bool enable = (coin(rng) < PROB_REENABLE_GENE);
+            (void)enable;
+            child.connections.setEnabled(i, true);
         }
-        // else: gene only in less-fit parent → skip
+        ++j;
     }
     return child;
 }
 
+static inline uint64_t hashMix(uint64_t h, uint64_t v) {
+    // splitmix64 finalizer folded into a running hash
+    v += 0x9e3779b97f4a7c15ull + h;
+    v = (v ^ (v >> 30)) * 0xbf58476d1ce4e5b9ull;
+    v = (v ^ (v >> 27)) * 0x94d049bb133111ebull;
+    return v ^ (v >> 31);
+}
+
+uint64_t Genome::structureHash() const {
+    uint64_t h = 0;
+    for (auto& kv : nodes)
+        h = hashMix(h, (uint64_t(kv.first) << 8) | uint64_t(kv.second.type));
+    for (size_t i = 0; i < connections.size(); ++i)
+        if (connections.enabled(i))
+            h = hashMix(h, (uint64_t(connections.from(i)) << 32) | connections.to(i));
+    return h;
+}
+
+uint64_t Genome::contentHash() const {
+    uint64_t h = structureHash();
+    for (size_t i = 0; i < connections.size(); ++i) {
+        if (!connections.enabled(i)) continue;
+        float w = connections.weight(i);
+        uint32_t bits;
+        std::memcpy(&bits, &w, sizeof(bits));
+        h = hashMix(h, (uint64_t(connections.innov(i)) << 32) | bits);
+    }
+    return h;
+}
+
 } // namespace neat
@@ -1,20 +1,63 @@
 // Genome.h
 #pragma once
+#include "ConnectionTable.h"
+#include "CowMap.h"
+#include "FitnessStats.h"
 #include "Gene.h"
+#include "NeatConfig.h"
+#include <memory>
 #include <vector>
-#include <map>
+#include <cstdint>
 
 namespace neat {
 
+struct GeneIndex;
+
+// Where a genome came from, recorded by NEAT for the genealogy log
+// (telemetry/Genealogy.h). IDs are unique within one NEAT instance and
+// never 0; a parent of 0 means none.
+struct Lineage {
+    enum Origin : uint8_t {
+        CLONE          = 1 << 0,   // elite carried over unchanged
+        CROSSOVER      = 1 << 1,   // of two distinct parents
+        WEIGHTS        = 1 << 2,
+        ADD_CONNECTION = 1 << 3,
+        ADD_NODE       = 1 << 4,
+        MIGRANT        = 1 << 5,   // imported from another island
+    };
+    uint64_t id = 0;
+    uint64_t parents[2] = { 0, 0 };   // fitter parent first
+    uint8_t  origin = 0;              // Origin bits
+};
+
+// Connection genes are an interned Topology plus per-genome weights and
+// enabled flags (ConnectionTable.h); node genes are copy-on-write
+// (CowMap.h). Copying a genome copies two flat arrays, and only a
+// structural change creates a new topology.
 struct Genome {
-    std::map<InnovId, ConnectionGene> connections;
-    std::map<NodeId, NodeGene> nodes;
+    ConnectionTable connections;
+    CowMap<NodeId, NodeGene> nodes;
     float fitness = 0.0f;
+    float novelty = 0.0f;   // set by the caller when novelty search is on
+    // every episode these exact genes played; mutation and crossover start
+    // it over, copies (elites carried over) keep adding to it
+    FitnessStats stats;
+    Lineage lineage;
+    // adjacency and order for the structural mutations (GeneIndex.h):
+    // built on first use, kept up to date by them, shared with copies and
+    // crossover children; rebuilt if the tables were changed elsewhere
+    std::shared_ptr<GeneIndex> geneIndex;
     // mutation/crossover APIs
-    void mutateAddConnection();
+    void mutateAddConnection(const NeatParams& params = NeatParams());
     void mutateAddNode();
-    void mutateWeights();
+    void mutateWeights(const NeatParams& params = NeatParams());
     static Genome crossover(const Genome& a, const Genome& b);
+
+    // hashes for caching derived data:
+    //  - structureHash: nodes + enabled connection endpoints (no weights)
+    //  - contentHash:   structure + weights, i.e. identical behaviour
+    uint64_t structureHash() const;
+    uint64_t contentHash() const;
 };
 
 } // namespace neat
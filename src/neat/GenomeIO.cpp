@@ -0,0 +1,154 @@
+// GenomeIO.cpp
+#include "GenomeIO.h"
+#include "InnovationTracker.h"
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+
+namespace neat {
+
+namespace {
+
+constexpr uint32_t GENOME_MAGIC   = 0x4d474e53; // "SNGM"
+constexpr uint16_t GENOME_VERSION = 1;
+
+struct Writer {
+    std::vector<uint8_t>& buf;
+    template<typename T> void put(T v) {
+        size_t at = buf.size();
+        buf.resize(at + sizeof(T));
+        std::memcpy(buf.data() + at, &v, sizeof(T));
+    }
+};
+
+struct Reader {
+    const uint8_t* p;
+    const uint8_t* end;
+    template<typename T> bool get(T& v) {
+        if (size_t(end - p) < sizeof(T)) return false;
+        std::memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+};
+
+struct Origin { NodeId from, to; };
+
+} // namespace
+
+bool encodeGenome(const Genome& g, std::vector<uint8_t>& out) {
+    auto& tracker = InnovationTracker::getInstance();
+
+    // 1) collect split origins for every hidden node, following the chain
+    //    until we reach nodes that are not the product of a split
+    std::unordered_map<NodeId, Origin> origins;
+    std::vector<NodeId> pending;
+    for (auto& kv : g.nodes)
+        if (kv.second.type == NodeGene::HIDDEN) pending.push_back(kv.first);
+    while (!pending.empty()) {
+        NodeId id = pending.back(); pending.pop_back();
+        if (origins.count(id)) continue;
+        Origin o;
+        if (!tracker.getSplitOrigin(id, o.from, o.to)) {
+            // a node outside the fixed input/bias/output block must have an origin
+            auto it = g.nodes.find(id);
+            if (it == g.nodes.end() || it->second.type == NodeGene::HIDDEN)
+                return false;
+            continue;
+        }
+        origins[id] = o;
+        pending.push_back(o.from);
+        pending.push_back(o.to);
+    }
+
+    // 2) write header, origins, nodes, connections
+    out.clear();
+    Writer w{out};
+    w.put(GENOME_MAGIC);
+    w.put(GENOME_VERSION);
+    w.put(uint16_t(0));
+    w.put(g.fitness);
+    w.put(uint32_t(origins.size()));
+    w.put(uint32_t(g.nodes.size()));
+    w.put(uint32_t(g.connections.size()));
+    for (auto& kv : origins) {
+        w.put(kv.first);
+        w.put(kv.second.from);
+        w.put(kv.second.to);
+    }
+    for (auto& kv : g.nodes) {
+        w.put(kv.first);
+        w.put(uint8_t(kv.second.type));
+    }
+    for (const auto& kv : g.connections) {
+        const auto& cg = kv.second;
+        w.put(cg.from);
+        w.put(cg.to);
+        w.put(cg.weight);
+        w.put(uint8_t(cg.enabled ? 1 : 0));
+    }
+    return true;
+}
+
+bool decodeGenome(const uint8_t* data, size_t size, Genome& out) {
+    Reader r{data, data + size};
+    uint32_t magic; uint16_t version, flags;
+    float fitness;
+    uint32_t originCount, nodeCount, connCount;
+    if (!r.get(magic) || magic != GENOME_MAGIC) return false;
+    if (!r.get(version) || version != GENOME_VERSION) return false;
+    if (!r.get(flags) || !r.get(fitness)) return false;
+    if (!r.get(originCount) || !r.get(nodeCount) || !r.get(connCount)) return false;
+
+    std::unordered_map<NodeId, Origin> origins;
+    for (uint32_t i = 0; i < originCount; ++i) {
+        NodeId id; Origin o;
+        if (!r.get(id) || !r.get(o.from) || !r.get(o.to)) return false;
+        origins[id] = o;
+    }
+
+    // map a foreign node ID onto the local namespace by replaying its split
+    auto& tracker = InnovationTracker::getInstance();
+    std::unordered_map<NodeId, NodeId> local;
+    std::unordered_set<NodeId> visiting;
+    bool ok = true;
+    std::function<NodeId(NodeId)> resolve = [&](NodeId id) -> NodeId {
+        auto lit = local.find(id);
+        if (lit != local.end()) return lit->second;
+        auto oit = origins.find(id);
+        if (oit == origins.end()) return local[id] = id;   // input/bias/output
+        if (!visiting.insert(id).second) { ok = false; return id; }  // cyclic origins
+        NodeId from = resolve(oit->second.from);
+        NodeId to   = resolve(oit->second.to);
+        InnovId split = tracker.getConnectionInnov(from, to);
+        NodeId nid = tracker.getSplitNodeId(split);
+        visiting.erase(id);
+        return local[id] = nid;
+    };
+
+    Genome g;
+    g.fitness = fitness;
+    for (uint32_t i = 0; i < nodeCount; ++i) {
+        NodeId id; uint8_t type;
+        if (!r.get(id) || !r.get(type) || type > NodeGene::OUTPUT) return false;
+        if (type == NodeGene::HIDDEN && !origins.count(id)) return false;
+        NodeId lid = resolve(id);
+        g.nodes[lid] = { lid, NodeGene::Type(type) };
+    }
+    std::vector<ConnectionGene> genes;
+    for (uint32_t i = 0; i < connCount; ++i) {
+        NodeId from, to; float weight; uint8_t enabled;
+        if (!r.get(from) || !r.get(to) || !r.get(weight) || !r.get(enabled)) return false;
+        NodeId lf = resolve(from), lt = resolve(to);
+        if (!g.nodes.count(lf) || !g.nodes.count(lt)) return false;
+        InnovId innov = tracker.getConnectionInnov(lf, lt);
+        genes.push_back({ innov, lf, lt, weight, enabled != 0 });
+    }
+    g.connections = ConnectionTable::fromGenes(std::move(genes));
+    if (!ok) return false;
+    out = std::move(g);
+    return true;
+}
+
+} // namespace neat
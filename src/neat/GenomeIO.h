@@ -0,0 +1,29 @@
+// GenomeIO.h
+#pragma once
+#include "Genome.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace neat {
+
+/**
+ * @brief  Portable binary encoding of a genome.
+ *
+ * Innovation numbers and hidden-node IDs are local to the process that
+ * minted them, so they are *not* written. Instead every connection is
+ * stored by its (from→to) endpoints and every hidden node by the (from→to)
+ * connection it split (transitively, down to inputs/bias/outputs).
+ * Decoding replays those splits against the local InnovationTracker, which
+ * reconciles the foreign IDs with the local innovation namespace.
+ */
+
+/// Serialize g into out (out is cleared first). Fails if a hidden node's
+/// split origin is unknown to the local tracker.
+bool encodeGenome(const Genome& g, std::vector<uint8_t>& out);
+
+/// Rebuild a genome from an encoded buffer, mapping every node and
+/// connection onto local IDs. Returns false on malformed input.
+bool decodeGenome(const uint8_t* data, size_t size, Genome& out);
+
+} // namespace neat
@@ -3,6 +3,7 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <cstdlib>
 
 namespace neat {
 
@@ -13,9 +14,12 @@ InnovationTracker& InnovationTracker::getInstance() {
 
 InnovationTracker::InnovationTracker()
   : nextConnInnov_(1),   // start at 1
-    nextNodeId_(1)       // will be bumped by initializeNodeCounter()
+    nextNodeId_(1),      // will be bumped by initializeNodeCounter()
+    dbFile_("innovation.db")
 {
     std::lock_guard<std::mutex> lk(mutex_);
+    if (const char* path = std::getenv("SNAKENEAT_INNOVATION_DB"))
+        dbFile_ = path;
     std::ifstream in(dbFile_);
     if (!in.is_open()) return;  // first run: no file yet
 
@@ -26,17 +30,20 @@ InnovationTracker::InnovationTracker()
         uint64_t key; InnovId innov;
         in >> key >> innov;
         connInnovMap_[key] = innov;
+        connKeyMap_[innov] = key;
     }
     in >> splitCount;
     for (size_t i = 0; i < splitCount; ++i) {
         InnovId connInnov; NodeId nid;
         in >> connInnov >> nid;
         splitNodeMap_[connInnov] = nid;
+        splitOriginMap_[nid] = connInnov;
     }
 }
 
 InnovationTracker::~InnovationTracker() {
     std::lock_guard<std::mutex> lk(mutex_);
+    if (!persist_) return;
     std::ofstream out(dbFile_, std::ofstream::trunc);
     if (!out.is_open()) {
         std::cerr << "Failed to save innovation DB to “" << dbFile_ << "”\n";
@@ -63,6 +70,7 @@ InnovId InnovationTracker::getConnectionInnov(NodeId from, NodeId to) {
     if (it != connInnovMap_.end()) return it->second;
     InnovId innov = nextConnInnov_++;
     connInnovMap_[key] = innov;
+    connKeyMap_[innov] = key;
     return innov;
 }
 
@@ -72,9 +80,26 @@ NodeId InnovationTracker::getSplitNodeId(InnovId connInnov) {
     if (it != splitNodeMap_.end()) return it->second;
     NodeId nid = nextNodeId_++;
     splitNodeMap_[connInnov] = nid;
+    splitOriginMap_[nid] = connInnov;
     return nid;
 }
 
+bool InnovationTracker::getSplitOrigin(NodeId node, NodeId& from, NodeId& to) const {
+    std::lock_guard<std::mutex> lk(mutex_);
+    auto sit = splitOriginMap_.find(node);
+    if (sit == splitOriginMap_.end()) return false;
+    auto kit = connKeyMap_.find(sit->second);
+    if (kit == connKeyMap_.end()) return false;
+    from = NodeId(kit->second >> 32);
+    to   = NodeId(kit->second & 0xffffffffu);
+    return true;
+}
+
+void InnovationTracker::disablePersistence() {
+    std::lock_guard<std::mutex> lk(mutex_);
+    persist_ = false;
+}
+
 void InnovationTracker::initializeNodeCounter(NodeId firstFreeId) {
     std::lock_guard<std::mutex> lk(mutex_);
     if (nextNodeId_ < firstFreeId) {
@@ -18,7 +18,9 @@ using InnovId = uint64_t;
  * - Assigns unique node IDs when splitting existing connections, re-using
  *   the same node ID if the same connection is split again.
  * - Persists its state in a simple text file so IDs remain consistent
- *   across runs.
+ *   across runs. The file defaults to "innovation.db" in the working
+ *   directory and can be moved with the SNAKENEAT_INNOVATION_DB environment
+ *   variable (needed when several trainers share one directory).
  */
 class InnovationTracker {
 public:
@@ -32,6 +34,10 @@ public:
     /// whose innovation number is connInnov.
     NodeId getSplitNodeId(InnovId connInnov);
 
+    /// Reverse lookup: the (from→to) connection that was split to create a
+    /// hidden node. Returns false if the node was not created by a split.
+    bool getSplitOrigin(NodeId node, NodeId& from, NodeId& to) const;
+
     /**
      * If your initial genomes define input IDs 0…inN-1 and output IDs
      * inN…inN+outN-1, call this *once* to ensure hidden-node IDs start
@@ -39,6 +45,10 @@ public:
      */
     void initializeNodeCounter(NodeId firstFreeId);
 
+    /// Do not write the database on exit (helper processes such as
+    /// evaluation workers mint throw-away IDs).
+    void disablePersistence();
+
 private:
     InnovationTracker();               // loads from disk
     ~InnovationTracker();              // saves to disk
@@ -56,7 +66,12 @@ private:
     // key = original connection InnovId → NodeId of the split node
     std::unordered_map<InnovId, NodeId>   splitNodeMap_;
 
-    const std::string dbFile_ = "innovation.db";
+    // reverse indices of the two maps above (rebuilt on load)
+    std::unordered_map<InnovId, uint64_t> connKeyMap_;
+    std::unordered_map<NodeId, InnovId>   splitOriginMap_;
+
+    std::string dbFile_;
+    bool persist_ = true;
 };
 
 } // namespace neat
@@ -0,0 +1,181 @@
+// Migration.cpp
+#include "Migration.h"
+#include "GenomeIO.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace neat {
+
+static constexpr uint32_t RING_MAGIC   = 0x474e5253; // "SRNG"
+static constexpr uint32_t RING_VERSION = 1;
+
+// Shared layout. Only lock-free atomics live in shared memory.
+struct MigrationRing::Header {
+    std::atomic<uint32_t> magic;       // written last by the creator
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t slotBytes;
+    std::atomic<uint64_t> head;        // next ticket to hand out
+};
+
+struct MigrationRing::Slot {
+    // 2*ticket+1 while being written, 2*ticket+2 once complete
+    std::atomic<uint64_t> seq;
+    uint32_t pid;
+    uint32_t bytes;
+    uint8_t  data[1];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "migration ring needs lock-free 64-bit atomics");
+
+static std::string shmName(const std::string& name) {
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+static size_t align64(size_t n) { return (n + 63) & ~size_t(63); }
+
+std::unique_ptr<MigrationRing> MigrationRing::open(const std::string& name,
+                                                   uint32_t slotCount,
+                                                   uint32_t slotBytes) {
+    std::unique_ptr<MigrationRing> ring(new MigrationRing());
+    std::string path = shmName(name);
+
+    // whoever creates the segment sizes and initializes it
+    bool creator = true;
+    int fd = shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        creator = false;
+        fd = shm_open(path.c_str(), O_RDWR, 0600);
+    }
+    if (fd < 0) {
+        std::cerr << "MigrationRing: shm_open(" << path << ") failed: "
+                  << std::strerror(errno) << "\n";
+        return nullptr;
+    }
+    ring->fd_ = fd;
+
+    if (creator) {
+        size_t stride = align64(offsetof(Slot, data) + slotBytes);
+        size_t bytes  = align64(sizeof(Header)) + stride * slotCount;
+        if (ftruncate(fd, off_t(bytes)) != 0) {
+            std::cerr << "MigrationRing: ftruncate failed: " << std::strerror(errno) << "\n";
+            return nullptr;
+        }
+    } else {
+        // wait for the creator to finish sizing the segment
+        struct stat st{};
+        for (int i = 0; i < 200 && (fstat(fd, &st) != 0 || st.st_size == 0); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        if (st.st_size < off_t(sizeof(Header))) {
+            std::cerr << "MigrationRing: " << path << " was never initialized\n";
+            return nullptr;
+        }
+    }
+
+    struct stat st{};
+    fstat(fd, &st);
+    ring->mapBytes_ = size_t(st.st_size);
+    ring->base_ = mmap(nullptr, ring->mapBytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ring->base_ == MAP_FAILED) {
+        ring->base_ = nullptr;
+        std::cerr << "MigrationRing: mmap failed: " << std::strerror(errno) << "\n";
+        return nullptr;
+    }
+    ring->header_ = static_cast<Header*>(ring->base_);
+    Header& h = *ring->header_;
+
+    if (creator) {
+        h.version   = RING_VERSION;
+        h.slotCount = slotCount;
+        h.slotBytes = slotBytes;
+        h.head.store(0, std::memory_order_relaxed);
+        h.magic.store(RING_MAGIC, std::memory_order_release);
+    } else {
+        for (int i = 0; i < 200 && h.magic.load(std::memory_order_acquire) != RING_MAGIC; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        if (h.magic.load(std::memory_order_acquire) != RING_MAGIC || h.version != RING_VERSION) {
+            std::cerr << "MigrationRing: " << path << " has an incompatible layout\n";
+            return nullptr;
+        }
+    }
+
+    ring->slotStride_ = align64(offsetof(Slot, data) + h.slotBytes);
+    if (align64(sizeof(Header)) + ring->slotStride_ * h.slotCount > ring->mapBytes_) {
+        std::cerr << "MigrationRing: " << path << " is truncated\n";
+        return nullptr;
+    }
+    ring->pid_ = uint32_t(getpid());
+    // a new member also picks up what is still in the ring
+    uint64_t head = h.head.load(std::memory_order_acquire);
+    ring->nextTicket_ = head > h.slotCount ? head - h.slotCount : 0;
+    ring->scratch_.resize(h.slotBytes);
+    return ring;
+}
+
+void MigrationRing::remove(const std::string& name) {
+    shm_unlink(shmName(name).c_str());
+}
+
+MigrationRing::~MigrationRing() {
+    if (base_) munmap(base_, mapBytes_);
+    if (fd_ >= 0) close(fd_);
+}
+
+MigrationRing::Slot* MigrationRing::slot(uint64_t ticket) const {
+    auto* first = static_cast<uint8_t*>(base_) + align64(sizeof(Header));
+    return reinterpret_cast<Slot*>(first + slotStride_ * (ticket % header_->slotCount));
+}
+
+bool MigrationRing::publish(const Genome& g) {
+    std::vector<uint8_t> buf;
+    if (!encodeGenome(g, buf) || buf.size() > header_->slotBytes)
+        return false;
+
+    uint64_t t = header_->head.fetch_add(1, std::memory_order_acq_rel);
+    Slot* s = slot(t);
+    s->seq.store(2 * t + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s->pid   = pid_;
+    s->bytes = uint32_t(buf.size());
+    std::memcpy(s->data, buf.data(), buf.size());
+    s->seq.store(2 * t + 2, std::memory_order_release);
+    return true;
+}
+
+std::vector<Genome> MigrationRing::collect(size_t maxCount) {
+    std::vector<Genome> out;
+    uint64_t head = header_->head.load(std::memory_order_acquire);
+    // anything older than one lap has been overwritten
+    if (head - nextTicket_ > header_->slotCount)
+        nextTicket_ = head - header_->slotCount;
+
+    for (; nextTicket_ < head && out.size() < maxCount; ++nextTicket_) {
+        uint64_t t = nextTicket_;
+        Slot* s = slot(t);
+        uint64_t before = s->seq.load(std::memory_order_acquire);
+        if (before != 2 * t + 2) continue;     // in flight, abandoned or lapped
+        uint32_t pid   = s->pid;
+        uint32_t bytes = s->bytes;
+        if (pid == pid_ || bytes > header_->slotBytes) continue;
+        std::memcpy(scratch_.data(), s->data, bytes);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s->seq.load(std::memory_order_relaxed) != before) continue;  // torn read
+
+        Genome g;
+        if (decodeGenome(scratch_.data(), bytes, g))
+            out.push_back(std::move(g));
+    }
+    return out;
+}
+
+} // namespace neat
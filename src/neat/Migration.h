@@ -0,0 +1,58 @@
+// Migration.h
+#pragma once
+#include "Genome.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace neat {
+
+/**
+ * @brief  Island-model migration between trainer processes (POSIX only).
+ *
+ * Several SnakeNEAT processes open the same named shared-memory ring and
+ * publish their elites into it. Each slot holds one genome in the portable
+ * GenomeIO encoding and is guarded by its own sequence counter, so a
+ * process that dies halfway through a write only leaves a slot that
+ * readers skip. Every process keeps its own NEAT instance and innovation
+ * namespace; IDs are reconciled by decodeGenome() on import.
+ */
+class MigrationRing {
+public:
+    /// Open (creating if needed) the ring "/name". Returns nullptr on failure.
+    static std::unique_ptr<MigrationRing> open(const std::string& name,
+                                               uint32_t slotCount = 64,
+                                               uint32_t slotBytes = 64 * 1024);
+    /// Remove the named ring from the system (existing mappings stay valid).
+    static void remove(const std::string& name);
+
+    ~MigrationRing();
+
+    /// Copy a genome into the next slot. Fails if it does not fit a slot.
+    bool publish(const Genome& g);
+
+    /// Decode up to maxCount genomes published by *other* processes since
+    /// the previous call.
+    std::vector<Genome> collect(size_t maxCount);
+
+private:
+    MigrationRing() = default;
+    MigrationRing(const MigrationRing&)            = delete;
+    MigrationRing& operator=(const MigrationRing&) = delete;
+
+    struct Header;
+    struct Slot;
+    Slot* slot(uint64_t ticket) const;
+
+    int      fd_        = -1;
+    void*    base_      = nullptr;
+    size_t   mapBytes_  = 0;
+    size_t   slotStride_ = 0;
+    Header*  header_    = nullptr;
+    uint64_t nextTicket_ = 0;   // first ticket not yet seen by collect()
+    uint32_t pid_       = 0;
+    std::vector<uint8_t> scratch_;
+};
+
+} // namespace neat
@@ -2,34 +2,40 @@
 #include "NEAT.h"
 #include "InnovationTracker.h"
 #include "NeatConfig.h"
+#include "cpu/Dispatch.h"
 #include <algorithm>
 #include <cmath>
 #include <numeric>
 #include <iostream>
-#include <set>
 using namespace neat;
 
-// NEAT‐tuning constants
-static constexpr float C1 = 1.0f;
-static constexpr float C2 = 1.0f;
-static constexpr float C3 = 0.4f;
-
-// Initial compatibility threshold
-static constexpr float INIT_COMPAT_THRESH   = 3.0f;
-// Target number of species (for dynamic thresholding)
-static constexpr int   TARGET_SPECIES_COUNT = 10;
-// How many gens without improvement before we kill a species
-static constexpr int   STAGNATION_LIMIT      = 100;
-// How much to bump threshold each adjust step
-static constexpr float THRESHOLD_STEP       = 0.3f;
-
-NEAT::NEAT(int popSize, int inN, int outN)
+bool NeatParams::set(const std::string& name, float value) {
+    if      (name == "weightPerturbProb")   weightPerturbProb   = value;
+    else if (name == "perturbStrength")     perturbStrength     = value;
+    else if (name == "probAddConnection")   probAddConnection   = value;
+    else if (name == "probAddNode")         probAddNode         = value;
+    else if (name == "c1")                  c1                  = value;
+    else if (name == "c2")                  c2                  = value;
+    else if (name == "c3")                  c3                  = value;
+    else if (name == "initCompatThreshold") initCompatThreshold = value;
+    else if (name == "targetSpeciesCount")  targetSpeciesCount  = int(value);
+    else if (name == "stagnationLimit")     stagnationLimit     = int(value);
+    else if (name == "thresholdStep")       thresholdStep       = value;
+    else if (name == "allowRecurrent")      allowRecurrent      = value != 0.0f;
+    else return false;
+    return true;
+}
+
+NEAT::NEAT(int popSize, int inN, int outN, const NeatParams& params)
  : popSize_(popSize),
+   inN_(inN),
+   outN_(outN),
    rng_(std::random_device{}()),
-   compatThreshold_(INIT_COMPAT_THRESH),
-   targetSpeciesCount_(TARGET_SPECIES_COUNT),
-   stagnationLimit_(STAGNATION_LIMIT),
-   thresholdAdjustStep_(THRESHOLD_STEP)
+   params_(params),
+   compatThreshold_(params.initCompatThreshold),
+   targetSpeciesCount_(params.targetSpeciesCount),
+   stagnationLimit_(params.stagnationLimit),
+   thresholdAdjustStep_(params.thresholdStep)
 {
     // --- 1) Decide on node ID ranges ---
     // Inputs:    [0 .. inN-1]
@@ -46,8 +52,10 @@ NEAT::NEAT(int popSize, int inN, int outN)
     std::uniform_real_distribution<float> weightDist(-1.0f, 1.0f);
 
     // --- 2) Create initial population ---
+    pop_.reserve(popSize_);
     for (int i = 0; i < popSize_; ++i) {
         Genome* g = new Genome();
+        g->lineage.id = nextGenomeId_++;
 
         // 2a) Add all input nodes
         for (NodeId nid = 0; nid < inN; ++nid) {
@@ -63,6 +71,7 @@ NEAT::NEAT(int popSize, int inN, int outN)
         }
 
         // 2d) Fully connect each input + bias → every output
+        std::vector<ConnectionGene> genes;
         for (NodeId src = 0; src <= inN; ++src) {            // 0..inN = inputs + bias
             for (NodeId dst = firstOutputId; 
                  dst < firstOutputId + outN; 
@@ -74,80 +83,180 @@ NEAT::NEAT(int popSize, int inN, int outN)
 
                 // Create the connection with a random initial weight
                 float w = weightDist(rng_);
-                g->connections[innov] = { innov, src, dst, w, true };
+                genes.push_back({ innov, src, dst, w, true });
             }
         }
+        g->connections = ConnectionTable::fromGenes(std::move(genes));
 
-        population_.push_back(g);
+        pop_.push(g);
     }
     // Now do an initial speciation so generation-0 species exist:
     speciate();
 }
 
 NEAT::~NEAT() {
-    for (auto* g: population_) delete g;
+    for (auto* g: pop_.genomes) delete g;
 }
 
 void NEAT::epoch(std::function<void(Genome&)> evalFunc) {
     // 1) evaluate
-    for (auto* g : population_) evalFunc(*g);
-
-    // 2) sort by raw fitness descending
-    std::sort(population_.begin(), population_.end(),
-              [](Genome* a, Genome* b){ return a->fitness > b->fitness; });
-    // 4) reproduce into next generation
-    reproduce();
-    // 2) immediately clear out every species’ member list
-    for (auto& s : species_) {
-        s.members.clear();
-    }    
+    for (auto* g : pop_.genomes) evalFunc(*g);
+    breed();
+}
+
+void NEAT::breed(const ChildFn& onChild) {
+    // 1) pick up the fitness written into the genomes by evaluation
+    pop_.gather();
+    if (noveltyWeight_ > 0.0f) blendNovelty();
+
+    // 2) reproduce into next generation (members sorted per species)
+    reproduce(onChild);
     // 3) speciate & prune stagnant species
     speciate();
     generation++;
 }
 
+bool NEAT::compact() {
+    if (compacted_) return true;
+
+    // species refer to genomes by index, so only the genomes need packing
+    std::vector<PackedGenome> packed(pop_.count());
+    for (size_t i = 0; i < pop_.count(); ++i)
+        if (!PackedGenome::pack(*pop_.genomes[i], inN_, outN_, packed[i])) return false;
+
+    for (auto* g : pop_.genomes) delete g;
+    pop_.genomes.clear();
+    packed_.swap(packed);
+    compacted_ = true;
+    return true;
+}
+
+void NEAT::expand() {
+    if (!compacted_) return;
+    pop_.genomes.reserve(packed_.size());
+    for (auto& p : packed_) pop_.genomes.push_back(new Genome(p.unpack()));
+    std::vector<PackedGenome>().swap(packed_);
+    compacted_ = false;
+}
+
+void NEAT::blendNovelty() {
+    if (pop_.count() == 0) return;
+    std::vector<float> novelty(pop_.count());
+    for (size_t i = 0; i < pop_.count(); ++i) novelty[i] = pop_.genomes[i]->novelty;
+    auto fr = std::minmax_element(pop_.fitness.begin(), pop_.fitness.end());
+    auto nr = std::minmax_element(novelty.begin(), novelty.end());
+    float fMin = *fr.first, fSpan = *fr.second - fMin;
+    float nMin = *nr.first, nSpan = *nr.second - nMin;
+    float w = std::min(noveltyWeight_, 1.0f);
+    float scale = fSpan > 0.0f ? fSpan : 1.0f;
+    for (size_t i = 0; i < pop_.count(); ++i) {
+        float f = fSpan > 0.0f ? (pop_.fitness[i] - fMin) / fSpan : 0.0f;
+        float n = nSpan > 0.0f ? (novelty[i] - nMin) / nSpan : 0.0f;
+        pop_.fitness[i] = fMin + scale * ((1.0f - w) * f + w * n);
+    }
+}
+
 Genome* NEAT::getBest() const {
-    if (population_.size() < 2) {
-        std::cerr << "ERROR: population_ has size " << population_.size() << " at generation " << generation << std::endl;
+    if (pop_.count() < 2) {
+        std::cerr << "ERROR: population has size " << pop_.count() << " at generation " << generation << std::endl;
         exit(1);
         // Optionally: exit(1);
     }
-    return population_.front();
+    return pop_.genomes.front();
 }
 
+int NEAT::immigrate(std::vector<Genome>&& migrants) {
+    // a migrant must carry exactly our input/bias/output block
+    auto compatible = [&](const Genome& g) {
+        int ins = 0, outs = 0;
+        for (auto& kv : g.nodes) {
+            NodeId id = kv.first;
+            switch (kv.second.type) {
+                case NodeGene::INPUT:  if (id >= NodeId(inN_)) return false; ins++; break;
+                case NodeGene::BIAS:   if (id != NodeId(inN_)) return false; break;
+                case NodeGene::OUTPUT:
+                    if (id <= NodeId(inN_) || id > NodeId(inN_ + outN_)) return false;
+                    outs++; break;
+                case NodeGene::HIDDEN: break;
+            }
+        }
+        return ins == inN_ && outs == outN_;
+    };
+
+    // candidates: everything that is not a species representative,
+    // weakest (by last known fitness) first
+    std::vector<uint8_t> isRep(pop_.count(), 0);
+    for (auto& s : species_) isRep[s.representative] = 1;
+    std::vector<uint32_t> victims;
+    for (uint32_t i = 0; i < pop_.count(); ++i)
+        if (!isRep[i]) victims.push_back(i);
+    std::sort(victims.begin(), victims.end(), [&](uint32_t a, uint32_t b) {
+        return pop_.fitness[a] < pop_.fitness[b];
+    });
+
+    int accepted = 0;
+    for (auto& m : migrants) {
+        if (accepted >= int(victims.size())) break;
+        if (!compatible(m)) continue;
+        uint32_t slot = victims[accepted++];
+        Genome* old = pop_.genomes[slot];
+        Genome* g = new Genome(std::move(m));
+        g->lineage = { nextGenomeId_++, { 0, 0 }, Lineage::MIGRANT };
+        pop_.replace(slot, g);
+        delete old;
+    }
+    return accepted;
+}
 
 float NEAT::compatibilityDistance(const Genome& A, const Genome& B) const {
-    // gather all innovation IDs
-    std::set<InnovId> allInnov;
-    for (auto& kv : A.connections) allInnov.insert(kv.first);
-    for (auto& kv : B.connections) allInnov.insert(kv.first);
+    const ConnectionTable& ca = A.connections;
+    const ConnectionTable& cb = B.connections;
+    double N = std::max(ca.size(), cb.size());
+    if (N < 20) N = 1;  // small‐genome normalization
+
+    // same topology: every gene matches, and the weights are already
+    // parallel arrays
+    if (ca.topology() == cb.topology()) {
+        double Wdiff = cpu::kernels().absDiffSum(ca.weights(), cb.weights(), ca.size());
+        double Wbar  = ca.size() > 0 ? Wdiff / ca.size() : 0.0;
+        return params_.c3 * Wbar;
+    }
 
     // find max innov in each
-    InnovId maxA = A.connections.empty() ? 0 : A.connections.rbegin()->first;
-    InnovId maxB = B.connections.empty() ? 0 : B.connections.rbegin()->first;
+    InnovId maxA = ca.empty() ? 0 : ca.innov(ca.size() - 1);
+    InnovId maxB = cb.empty() ? 0 : cb.innov(cb.size() - 1);
+    InnovId shared = std::min(maxA, maxB);
 
     int E = 0, D = 0;
-    double Wdiff = 0;
-    int matching = 0;
-
-    for (InnovId innov : allInnov) {
-        auto itA = A.connections.find(innov);
-        auto itB = B.connections.find(innov);
-        if (itA != A.connections.end() && itB != B.connections.end()) {
+    auto unmatched = [&](InnovId innov) {
+        // disjoint vs excess
+        if (innov > shared) E++;
+        else                D++;
+    };
+
+    // walk both (innovation-ordered) gene lists at once; matching genes'
+    // weights are collected for one vectorized difference sum
+    static thread_local std::vector<float> wa, wb;
+    wa.clear();
+    wb.clear();
+    size_t ia = 0, ib = 0, na = ca.size(), nb = cb.size();
+    while (ia < na && ib < nb) {
+        if (ca.innov(ia) < cb.innov(ib))      unmatched(ca.innov(ia++));
+        else if (cb.innov(ib) < ca.innov(ia)) unmatched(cb.innov(ib++));
+        else {
             // matching gene
-            matching++;
-            Wdiff += std::fabs(itA->second.weight - itB->second.weight);
-        } else {
-            // disjoint vs excess
-            if (innov > maxA || innov > maxB) E++;
-            else                               D++;
+            wa.push_back(ca.weight(ia++));
+            wb.push_back(cb.weight(ib++));
         }
     }
+    for (; ia < na; ++ia) unmatched(ca.innov(ia));
+    for (; ib < nb; ++ib) unmatched(cb.innov(ib));
+
+    int matching = int(wa.size());
+    double Wdiff = cpu::kernels().absDiffSum(wa.data(), wb.data(), wa.size());
 
     double Wbar = matching>0 ? Wdiff / matching : 0.0;
-    double N = std::max(A.connections.size(), B.connections.size());
-    if (N < 20) N = 1;  // small‐genome normalization
-    return (C1*E + C2*D) / N + C3 * Wbar;
+    return (params_.c1*E + params_.c2*D) / N + params_.c3 * Wbar;
 }
 
 void NEAT::speciate() {
@@ -164,38 +273,62 @@ void NEAT::speciate() {
         s.resetForNextGen();
 
     // assign each genome to a species (or make a new one)
-    for (auto* g : population_) {
-        bool placed = false;
-        for (auto& s : species_) {
-            if (compatibilityDistance(*g, *s.representative) <= compatThreshold_) {
-                s.members.push_back(g);
-                placed = true;
+    const uint32_t n = uint32_t(pop_.count());
+    for (uint32_t i = 0; i < n; ++i) {
+        const Genome& g = *pop_.genomes[i];
+        uint32_t placed = Population::NO_SPECIES;
+        for (uint32_t k = 0; k < species_.size(); ++k) {
+            if (compatibilityDistance(g, *pop_.genomes[species_[k].representative]) <= compatThreshold_) {
+                placed = k;
                 break;
             }
         }
-        if (!placed) {
+        if (placed == Population::NO_SPECIES) {
             Species newS;
-            newS.representative = g;
-            newS.members.push_back(g);
+            newS.id = nextSpeciesId_++;
+            newS.representative = i;
+            placed = uint32_t(species_.size());
             species_.push_back(std::move(newS));
         }
+        pop_.species[i] = placed;
+        species_[placed].count++;
+    }
+
+    // group the members by species, keeping population order within each
+    uint32_t next = 0;
+    for (auto& s : species_) {
+        s.first = next;
+        next += s.count;
+        s.count = 0;
+    }
+    pop_.members.resize(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        Species& s = species_[pop_.species[i]];
+        pop_.members[s.first + s.count++] = i;
     }
 
-    // update each species: new representative, stagnation, possibly cull
+    // update each species: new representative, stagnation, possibly cull.
+    // The species holding the fittest genome is never culled: a generation
+    // dealt hard food can leave every species short of its record.
+    float bestOverall = 0;
+    for (uint32_t i = 0; i < n; ++i)
+        bestOverall = std::max(bestOverall, pop_.fitness[i]);
+    std::vector<uint32_t> renumber(species_.size(), Population::NO_SPECIES);
     std::vector<Species> survivors;
     survivors.reserve(species_.size());
-    for (auto& s : species_) {
+    for (size_t k = 0; k < species_.size(); ++k) {
+        Species& s = species_[k];
         // 1) if it's empty, drop it immediately
-        if (s.members.empty()) 
+        if (s.count == 0)
             continue;
 
         // 2) pick new rep
-        s.representative = s.members.front();
+        s.representative = pop_.members[s.first];
 
         // 3) check stagnation
         float bestThisGen = 0;
-        for (auto* g : s.members)
-            bestThisGen = std::max(bestThisGen, g->fitness);
+        for (uint32_t m = s.first; m < s.first + s.count; ++m)
+            bestThisGen = std::max(bestThisGen, pop_.fitness[pop_.members[m]]);
 
         if (bestThisGen > s.bestFitnessEver) {
             s.bestFitnessEver      = bestThisGen;
@@ -205,13 +338,16 @@ void NEAT::speciate() {
         }
 
         // 4) only keep if still alive
-        if (s.gensSinceImprovement <= stagnationLimit_)
+        if (s.gensSinceImprovement <= stagnationLimit_ || bestThisGen >= bestOverall) {
+            renumber[k] = uint32_t(survivors.size());
             survivors.push_back(std::move(s));
+        }
     }
     species_.swap(survivors);
+    for (uint32_t i = 0; i < n; ++i) pop_.species[i] = renumber[pop_.species[i]];
 }
 
-void NEAT::reproduce() {
+void NEAT::reproduce(const ChildFn& onChild) {
     if (species_.empty()) {
     std::cerr << "No species to reproduce from! Skipping reproduce().\n";
     return;
@@ -222,12 +358,13 @@ void NEAT::reproduce() {
     // 1) compute adjusted fitness & total
     double totalAdjusted = 0.0;
     for (auto& s : species_) {
-        int m = s.members.size();
-        for (auto* g : s.members) {
-            double adj = g->fitness / double(m);
-            s.adjustedFitnessSum += adj;
-            totalAdjusted += adj;
+        double m = double(s.count);
+        for (uint32_t k = s.first; k < s.first + s.count; ++k) {
+            uint32_t i = pop_.members[k];
+            pop_.adjusted[i] = float(pop_.fitness[i] / m);
+            s.adjustedFitnessSum += pop_.fitness[i] / m;
         }
+        totalAdjusted += s.adjustedFitnessSum;
     }
 
     // 2) allocate offspring quotas
@@ -267,8 +404,8 @@ void NEAT::reproduce() {
     }
 
     // 3) build new population
-    std::vector<Genome*> newPop;
-    newPop.reserve(popSize_);
+    Population next;
+    next.reserve(popSize_);
     std::uniform_real_distribution<float> uni(0,1);
 
     for (size_t i = 0; i < species_.size(); ++i) {
@@ -277,35 +414,47 @@ void NEAT::reproduce() {
         if (q <= 0) continue;
 
         // sort members by raw fitness descending
-        std::sort(s.members.begin(), s.members.end(),
-                  [](Genome* a, Genome* b){ return a->fitness > b->fitness; });
-
+        uint32_t* members = pop_.members.data() + s.first;
+        std::sort(members, members + s.count,
+                  [&](uint32_t a, uint32_t b){ return pop_.fitness[a] > pop_.fitness[b]; });
 
         // --- 3a) elitism: carry over the best ---
-        // create a copy of the species’ best genome…
-        Genome* repChild = new Genome(*s.members[0]);
-        // …and immediately update the representative pointer so it never dangles:
-        s.representative = repChild;
-        newPop.push_back(repChild);
+        // create a copy of the species’ best genome, which becomes the
+        // representative in the next population
+        const Genome& best = *pop_.genomes[members[0]];
+        Genome* repChild = new Genome(best);
+        repChild->lineage = { nextGenomeId_++, { best.lineage.id, 0 }, Lineage::CLONE };
+        s.representative = next.push(repChild, pop_.age[members[0]] + 1);
+        if (onChild) onChild(s.representative, *repChild);
         q--;
         
         // --- 3b) fill the rest by intra‐species crossover+mutation ---
         std::vector<double> weights;
-        weights.reserve(s.members.size());
-        for (auto* g : s.members)
-            weights.push_back(g->fitness / double(s.members.size()));
+        weights.reserve(s.count);
+        for (uint32_t k = 0; k < s.count; ++k)
+            weights.push_back(pop_.adjusted[members[k]]);
         std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
 
         for (int j = 0; j < q; ++j) {
-            Genome* p1 = s.members[pick(rng_)];
-            Genome* p2 = s.members[pick(rng_)];
-            if (p2->fitness > p1->fitness) std::swap(p1,p2);
+            uint32_t i1 = members[pick(rng_)];
+            uint32_t i2 = members[pick(rng_)];
+            if (pop_.fitness[i2] > pop_.fitness[i1]) std::swap(i1, i2);
+            const Genome* p1 = pop_.genomes[i1];
+            const Genome* p2 = pop_.genomes[i2];
 
             Genome* child = new Genome(Genome::crossover(*p1,*p2));
-            child->mutateWeights();
-            if (uni(rng_) < PROB_ADD_CONNECTION) child->mutateAddConnection();
-            if (uni(rng_) < PROB_ADD_NODE)       child->mutateAddNode();
-            newPop.push_back(child);
+            child->mutateWeights(params_);
+            uint8_t origin = Lineage::WEIGHTS | (p1 != p2 ? Lineage::CROSSOVER : 0);
+            size_t conns = child->connections.size();
+            if (uni(rng_) < params_.probAddConnection) child->mutateAddConnection(params_);
+            if (child->connections.size() != conns) origin |= Lineage::ADD_CONNECTION;
+            size_t nodes = child->nodes.size();
+            if (uni(rng_) < params_.probAddNode)       child->mutateAddNode();
+            if (child->nodes.size() != nodes) origin |= Lineage::ADD_NODE;
+            child->lineage = { nextGenomeId_++,
+                               { p1->lineage.id, p1 != p2 ? p2->lineage.id : 0 }, origin };
+            uint32_t index = next.push(child);
+            if (onChild) onChild(index, *child);
         }
     }
 
@@ -322,17 +471,15 @@ void NEAT::reproduce() {
     }
 
     // --- 4) swap-and-delete old population in one clean move ---
-    std::vector<Genome*> oldPop;
-    oldPop.swap(population_);       // take ownership of the old pointers
-    population_.swap(newPop);       // now population_ is the brand-new generation
+    std::swap(pop_, next);          // now pop_ is the brand-new generation
 
     // now it's safe to delete the old generation, since nothing refers to them any more
-    for (auto* g : oldPop) {
+    for (auto* g : next.genomes) {
         delete g;
     }
 
-    if (population_.size() != popSize_) {
-        std::cerr << "ERROR: newPop.size() = " << population_.size() << " expected " << popSize_ << std::endl;
+    if (pop_.count() != size_t(popSize_)) {
+        std::cerr << "ERROR: newPop.size() = " << pop_.count() << " expected " << popSize_ << std::endl;
     }
 
 }
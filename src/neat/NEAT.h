@@ -3,6 +3,9 @@
 #include "Genome.h"
 #include "Network.h"
 #include "Species.h"
+#include "Population.h"
+#include "NeatConfig.h"
+#include "PackedGenome.h"
 #include <vector>
 #include <random>
 #include <functional>
@@ -10,24 +13,64 @@
 namespace neat {
 
 struct NEAT {
-    NEAT(int popSize, int inN, int outN);
+    NEAT(int popSize, int inN, int outN, const NeatParams& params = NeatParams());
     ~NEAT();
 
     // Evaluate+sort externally, then:
     void epoch(std::function<void(Genome&)> evalFunc);
 
+    // epoch() without the evaluation pass, for pipelined training: onChild
+    // gets every offspring (and its index in the next population) the
+    // moment reproduce() creates it, so evaluating it can overlap the rest
+    // of reproduction and speciation. Speciation reads fitness, so results
+    // must not be written into the offspring before breed() returns.
+    using ChildFn = std::function<void(size_t index, const Genome& child)>;
+    void breed(const ChildFn& onChild = ChildFn());
+
     Genome* getBest() const;
 
+    // Novelty search: with w > 0, selection uses a blend of each genome's
+    // fitness and novelty (both min-max normalized over the population,
+    // mapped back onto the fitness range). w = 1 is pure novelty search.
+    // The blend only ranks genomes; Genome::fitness stays the game's.
+    void setNoveltyWeight(float w) { noveltyWeight_ = w; }
+
+    // Replace the weakest non-representative genomes of the current
+    // population with migrants from other islands, in place (indices and
+    // species keep pointing at the slot). Migrants whose input/output
+    // layout does not match are ignored. Returns #accepted.
+    int immigrate(std::vector<Genome>&& migrants);
+
+    // Keep the population as PackedGenomes between generations, e.g. while
+    // a sweep experiment waits for its next turn. population() is empty
+    // while compacted; expand() restores it at the same indices.
+    // compact() fails (changing nothing) if a genome cannot be packed.
+    bool compact();
+    void expand();
+    bool compacted() const { return compacted_; }
+
     const std::vector<Species>& species()    const { return species_; }
-    const std::vector<Genome*>& population() const { return population_; }
+    const std::vector<Genome*>& population() const { return pop_.genomes; }
+    // k-th member of s, 0 <= k < s.count
+    Genome* member(const Species& s, size_t k) const { return pop_.genomes[pop_.members[s.first + k]]; }
+    float compatThreshold() const { return compatThreshold_; }
     int generation = 0;
 
 private:
     int popSize_;
-    std::vector<Genome*> population_;
+    int inN_, outN_;
+    Population pop_;
     std::vector<Genome*> top10_;
     std::vector<Species> species_;
     std::mt19937 rng_;
+    NeatParams   params_;
+    uint64_t     nextGenomeId_  = 1;
+    uint32_t     nextSpeciesId_ = 1;
+    float        noveltyWeight_ = 0.0f;
+
+    // compacted population: the genomes, by index (the columns stay in pop_)
+    bool compacted_ = false;
+    std::vector<PackedGenome> packed_;
 
     // speciation & reproduction params:
     float compatThreshold_;
@@ -36,8 +79,9 @@ private:
     float thresholdAdjustStep_;
 
     // core steps:
+    void blendNovelty();
     void speciate();
-    void reproduce();
+    void reproduce(const ChildFn& onChild);
 
     // compute compatibility distance between two genomes
     float compatibilityDistance(const Genome& a, const Genome& b) const;
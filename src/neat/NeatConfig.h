@@ -1,5 +1,6 @@
 // NeatConfig.h
 #pragma once
+#include <string>
 
 namespace neat {
 
@@ -16,4 +17,41 @@ constexpr float PROB_ADD_NODE         = 0.006f;
 // When a matching gene is disabled in either parent, re-enable it with this chance
 constexpr float PROB_REENABLE_GENE    = 0.005f;
 
+// Compatibility distance coefficients (excess, disjoint, weight difference)
+constexpr float C1 = 1.0f;
+constexpr float C2 = 1.0f;
+constexpr float C3 = 0.4f;
+
+// Initial compatibility threshold
+constexpr float INIT_COMPAT_THRESH   = 3.0f;
+// Target number of species (for dynamic thresholding)
+constexpr int   TARGET_SPECIES_COUNT = 10;
+// How many gens without improvement before we kill a species
+constexpr int   STAGNATION_LIMIT     = 100;
+// How much to bump threshold each adjust step
+constexpr float THRESHOLD_STEP       = 0.3f;
+
+/**
+ * Runtime copy of the knobs above, one per NEAT instance, so that several
+ * differently tuned populations can evolve in the same process.
+ */
+struct NeatParams {
+    float weightPerturbProb   = WEIGHT_PERTURB_PROB;
+    float perturbStrength     = PERTURB_STRENGTH;
+    float probAddConnection   = PROB_ADD_CONNECTION;
+    float probAddNode         = PROB_ADD_NODE;
+    float c1                  = C1;
+    float c2                  = C2;
+    float c3                  = C3;
+    float initCompatThreshold = INIT_COMPAT_THRESH;
+    int   targetSpeciesCount  = TARGET_SPECIES_COUNT;
+    int   stagnationLimit     = STAGNATION_LIMIT;
+    float thresholdStep       = THRESHOLD_STEP;
+    // add-connection may close cycles (needs RecurrentNetwork to evaluate)
+    bool  allowRecurrent      = false;
+
+    /// Set a field by name (as spelled above). False for an unknown name.
+    bool set(const std::string& name, float value);
+};
+
 } // namespace neat
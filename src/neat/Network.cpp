@@ -1,30 +1,34 @@
 // Network.cpp
 #include "Network.h"
+#include "Activation.h"
+#include <algorithm>
 #include <unordered_map>
 #include <queue>
 #include <cmath>
 #include <iostream>
+#include <stdexcept>
 using namespace neat;
 
 Network::Network(const Genome& g)
  : genome_(g)
 {
     buildTopology();
+    flatten();
 }
 
 void Network::buildTopology() {
     // simple Kahn’s algorithm: nodes with no incoming edges first
     std::unordered_map<NodeId,int> indeg;
     for (auto& kv : genome_.nodes) indeg[kv.first] = 0;
-    for (auto& kv : genome_.connections) if (kv.second.enabled)
+    for (const auto& kv : genome_.connections) if (kv.second.enabled)
         indeg[kv.second.to]++;
     std::queue<NodeId> q;
     for (auto& kv : indeg) if (kv.second==0) q.push(kv.first);
     while (!q.empty()) {
         NodeId n = q.front(); q.pop();
         topoOrder_.push_back(n);
-        for (auto& kv : genome_.connections) {
-            auto& cg = kv.second;
+        for (const auto& kv : genome_.connections) {
+            const auto& cg = kv.second;
             if (cg.enabled && cg.from==n) {
                 if (--indeg[cg.to]==0) q.push(cg.to);
             }
@@ -32,50 +36,62 @@ void Network::buildTopology() {
     }
 }
 
-std::vector<float> Network::feed(const std::vector<float>& in) {
-    std::unordered_map<NodeId,float> values;
-    size_t i = 0;
-    // 1) initialize all node values
+void Network::flatten() {
+    std::unordered_map<NodeId, uint32_t> slot;
     for (auto& kv : genome_.nodes) {
-        auto type = kv.second.type;
-        if (type == NodeGene::INPUT)
-            values[kv.first] = in.at(i++);
-        else if (type == NodeGene::BIAS)
-            values[kv.first] = 1.0f;
-        else
-            values[kv.first] = 0.0f;
+        uint32_t i = uint32_t(ids_.size());
+        slot.emplace(kv.first, i);
+        ids_.push_back(kv.first);
+        init_.push_back(kv.second.type == NodeGene::BIAS ? 1.0f : 0.0f);
+        if (kv.second.type == NodeGene::INPUT)  inputs_.push_back(i);
+        if (kv.second.type == NodeGene::OUTPUT) outputSlots_.push_back(i);
     }
 
-    // 2) propagate in topological order
-    for (NodeId nid : topoOrder_) {
-        float v = values[nid];
-        for (auto& ck : genome_.connections) {
-            auto& cg = ck.second;
-            if (cg.enabled && cg.from == nid) {
-                values[cg.to] += v * cg.weight;
-            }
-        }
+    std::unordered_map<NodeId, std::vector<ConnectionGene>> outgoing;
+    for (const auto& kv : genome_.connections) {
+        const auto& cg = kv.second;
+        if (cg.enabled && slot.count(cg.to)) outgoing[cg.from].push_back(cg);
+    }
 
-        // 3) activation — guard the at()
+    for (NodeId nid : topoOrder_) {
         auto nodeIt = genome_.nodes.find(nid);
-        if (nodeIt == genome_.nodes.end()) {
-            // this should never happen if your genome is consistent,
-            // but we skip it to avoid the crash:
-            continue;
-        }
+        if (nodeIt == genome_.nodes.end()) continue;   // inconsistent genome
         auto type = nodeIt->second.type;
-        if (type == NodeGene::HIDDEN || type == NodeGene::OUTPUT) {
-            values[nid] = std::tanh(values[nid]);
+        bool squash = type == NodeGene::HIDDEN || type == NodeGene::OUTPUT;
+        steps_.push_back({ slot[nid], uint32_t(edgeDst_.size()), squash,
+                           squash ? activationFor(type) : Activation::LINEAR });
+        for (const ConnectionGene& cg : outgoing[nid]) {
+            edgeDst_.push_back(slot[cg.to]);
+            edgeW_.push_back(cg.weight);
         }
     }
-    activations_ = values;
+    steps_.push_back({ 0, uint32_t(edgeDst_.size()), false, Activation::LINEAR });   // sentinel
 
-    // 4) collect outputs
-    std::vector<float> out;
-    for (auto& kv : genome_.nodes) {
-        if (kv.second.type == NodeGene::OUTPUT) {
-            out.push_back(values[kv.first]);
-        }
-    }
-    return out;
+    values_ = init_;
+    out_.resize(outputSlots_.size());
+}
+
+const std::vector<float>& Network::feed(const float* in, size_t n) {
+    if (n < inputs_.size()) throw std::out_of_range("Network::feed: too few inputs");
+
+    // 1) initialize all node values
+    float* x = values_.data();
+    std::copy(init_.begin(), init_.end(), values_.begin());
+    for (size_t i = 0; i < inputs_.size(); ++i) x[inputs_[i]] = in[i];
+
+    // 2) propagate in topological order: push each node's value along its
+    //    out-edges, then activate it
+    cpu::kernels().pushProgram(steps_.data(), steps_.size() - 1, edgeDst_.data(), edgeW_.data(), x);
+    fed_ = true;
+    activations_.clear();
+
+    // 3) collect outputs
+    for (size_t i = 0; i < outputSlots_.size(); ++i) out_[i] = x[outputSlots_[i]];
+    return out_;
+}
+
+const std::unordered_map<NodeId, float>& Network::getActivations() const {
+    if (fed_ && activations_.empty())
+        for (size_t i = 0; i < ids_.size(); ++i) activations_[ids_[i]] = values_[i];
+    return activations_;
 }
@@ -1,29 +1,52 @@
 // Network.h
 #pragma once
+#include "Activation.h"
 #include "Gene.h"
 #include "Genome.h"
+#include "cpu/Dispatch.h"
+#include <cstdint>
 #include <vector>
-#include <unordered_map> 
+#include <unordered_map>
 
 namespace neat {
 
 class Network {
 public:
     explicit Network(const Genome& g);
-    // Feedforward: inputs → outputs; records per-node activations
-    std::vector<float> feed(const std::vector<float>& in);
+    // Feedforward: inputs → outputs. Does not allocate; the returned
+    // outputs stay valid until the next call.
+    const std::vector<float>& feed(const std::vector<float>& in) { return feed(in.data(), in.size()); }
+    // Same from n floats, e.g. a std::array
+    const std::vector<float>& feed(const float* in, size_t n);
 
-    // Access the last activation values by node ID
-    const std::unordered_map<NodeId, float>& getActivations() const { return activations_; }
+    // Access the last activation values by node ID (built on first use)
+    const std::unordered_map<NodeId, float>& getActivations() const;
 
     // Access genome for structure
     const Genome& getGenome() const { return genome_; }
 
+    // Evaluation order used by feed(); nodes caught in a cycle are absent
+    const std::vector<NodeId>& order() const { return topoOrder_; }
+
 private:
+    // topoOrder_ flattened into dense node slots (node-ID order) and
+    // per-node out-edge ranges, in the genome's connection order; run by
+    // cpu::kernels().pushProgram
     const Genome& genome_;
     std::vector<NodeId> topoOrder_;
-    std::unordered_map<NodeId, float> activations_;  // recorded after feed
+    std::vector<NodeId>   ids_;        // slot → node ID
+    std::vector<float>    init_;       // 1 for bias, 0 otherwise
+    std::vector<uint32_t> inputs_;     // slots of input nodes, in input order
+    std::vector<uint32_t> outputSlots_;
+    std::vector<cpu::NetStep> steps_;  // + sentinel
+    std::vector<uint32_t> edgeDst_;
+    std::vector<float>    edgeW_;
+    std::vector<float>    values_;
+    std::vector<float>    out_;
+    bool fed_ = false;
+    mutable std::unordered_map<NodeId, float> activations_;  // recorded after feed
     void buildTopology();
+    void flatten();
 };
 
 } // namespace neat
@@ -0,0 +1,308 @@
+// NetworkJit.cpp
+#include "NetworkJit.h"
+#include "Activation.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#ifndef _WIN32
+#include <dlfcn.h>
+#include <unistd.h>
+#endif
+
+namespace neat {
+
+static const char* KERNEL_SYMBOL = "snake_neat_feed";
+
+// ---------------------------------------------------------------------------
+// Code generation
+// ---------------------------------------------------------------------------
+
+// expression applying a to variable v, using the kernels pasted into the source
+static std::string activationExpr(Activation a, const std::string& v) {
+    switch (a) {
+        case Activation::TANH:      return "std::tanh(" + v + ")";
+        case Activation::FAST_TANH: return "snn_fast_tanh(" + v + ")";
+        case Activation::LUT_TANH:  return "snn_lut_tanh(" + v + ")";
+        case Activation::SIGMOID:   return "1.0f / (1.0f + std::exp(-" + v + "))";
+        case Activation::RELU:      return "std::max(0.0f, " + v + ")";
+        case Activation::LINEAR:    return v;
+    }
+    return v;
+}
+
+// cache key: same weights under a different activation setup is a different kernel
+static uint64_t kernelKey(const Genome& g) {
+    return g.contentHash() ^ (uint64_t(activationFor(NodeGene::HIDDEN)) << 56)
+                           ^ (uint64_t(activationFor(NodeGene::OUTPUT)) << 60);
+}
+
+std::string emitNetworkSource(const Genome& g) {
+    // dense index for every node, in node-ID order (the order feed() uses)
+    std::unordered_map<NodeId, size_t> dense;
+    for (auto& kv : g.nodes) dense.emplace(kv.first, dense.size());
+
+    // outgoing enabled connections per node
+    std::unordered_map<NodeId, std::vector<ConnectionGene>> out;
+    for (const auto& kv : g.connections) {
+        const auto& cg = kv.second;
+        if (!cg.enabled) continue;
+        if (!dense.count(cg.from) || !dense.count(cg.to)) return {};
+        if (!std::isfinite(cg.weight)) return {};
+        out[cg.from].push_back(cg);
+    }
+
+    std::ostringstream src;
+    src << "// generated by SnakeNEAT for genome " << std::hex << g.contentHash() << std::dec << "\n"
+        << "#include <algorithm>\n#include <cmath>\n"
+        << activationKernelSource() << "\n"
+        << "extern \"C\" void " << KERNEL_SYMBOL << "(const float* in, float* out) {\n";
+
+    // 1) initial values, same rules as Network::feed
+    size_t inputIdx = 0;
+    for (auto& kv : g.nodes) {
+        size_t i = dense[kv.first];
+        switch (kv.second.type) {
+            case NodeGene::INPUT: src << "    float x" << i << " = in[" << inputIdx++ << "];\n"; break;
+            case NodeGene::BIAS:  src << "    float x" << i << " = 1.0f;\n"; break;
+            default:              src << "    float x" << i << " = 0.0f;\n"; break;
+        }
+    }
+
+    // 2) propagate in the interpreter's topological order; weights are
+    //    written as hex floats so the kernel matches bit for bit
+    Network ref(g);
+    char w[64];
+    for (NodeId nid : ref.order()) {
+        size_t i = dense[nid];
+        auto it = out.find(nid);
+        if (it != out.end()) {
+            for (const ConnectionGene& cg : it->second) {
+                std::snprintf(w, sizeof(w), "%af", double(cg.weight));
+                src << "    x" << dense[cg.to] << " += x" << i << " * " << w << ";\n";
+            }
+        }
+        auto type = g.nodes.at(nid).type;
+        if (type == NodeGene::HIDDEN || type == NodeGene::OUTPUT) {
+            std::string v = "x" + std::to_string(i);
+            src << "    " << v << " = " << activationExpr(activationFor(type), v) << ";\n";
+        }
+    }
+
+    // 3) publish every node value
+    for (size_t i = 0; i < dense.size(); ++i)
+        src << "    out[" << i << "] = x" << i << ";\n";
+    src << "}\n";
+    return src.str();
+}
+
+// ---------------------------------------------------------------------------
+// Compiler service
+// ---------------------------------------------------------------------------
+
+JitKernel::~JitKernel() {
+#ifndef _WIN32
+    if (handle) dlclose(handle);
+#endif
+}
+
+JitCompiler& JitCompiler::getInstance() {
+    static JitCompiler inst;
+    return inst;
+}
+
+JitCompiler::JitCompiler() {
+#ifndef _WIN32
+    const char* flag = std::getenv("SNAKENEAT_JIT");
+    if (flag && std::string(flag) == "0") return;
+    const char* cxx = std::getenv("SNAKENEAT_JIT_CXX");
+    cxx_ = cxx ? cxx : "c++";
+    if (const char* cap = std::getenv("SNAKENEAT_JIT_CACHE"))
+        maxLoaded_ = size_t(std::max(1, std::atoi(cap)));
+    if (std::system((cxx_ + " --version > /dev/null 2>&1").c_str()) != 0) {
+        std::cerr << "JIT: no working compiler (" << cxx_ << "), using the interpreter\n";
+        return;
+    }
+    const char* tmp = std::getenv("TMPDIR");
+    std::string tmpl = std::string(tmp ? tmp : "/tmp") + "/snakeneat-jit-XXXXXX";
+    std::vector<char> buf(tmpl.begin(), tmpl.end());
+    buf.push_back('\0');
+    if (!mkdtemp(buf.data())) {
+        std::cerr << "JIT: cannot create a scratch directory, using the interpreter\n";
+        return;
+    }
+    dir_ = buf.data();
+    enabled_ = true;
+#endif
+}
+
+JitCompiler::~JitCompiler() {
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+    // kernels still referenced by a network stay mapped until it goes
+#ifndef _WIN32
+    if (!dir_.empty()) rmdir(dir_.c_str());
+#endif
+}
+
+std::shared_ptr<const JitKernel> JitCompiler::find(const Genome& g, bool request) {
+    if (!enabled_) return nullptr;
+    uint64_t key = kernelKey(g);
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        auto it = cache_.find(key);
+        if (it != cache_.end()) {
+            if (it->second.state != Entry::READY) return nullptr;
+            it->second.lastUse = ++useClock_;
+            return it->second.kernel;
+        }
+        // bound the backlog; anything hot enough will be asked for again
+        if (!request || jobs_.size() >= 16) return nullptr;
+    }
+
+    std::string source = emitNetworkSource(g);
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (cache_.count(key)) return nullptr;
+    if (source.empty()) {
+        cache_[key] = { Entry::FAILED, nullptr };
+        return nullptr;
+    }
+    cache_[key] = { Entry::QUEUED, nullptr };
+    jobs_.push_back({ key, std::move(source) });
+    if (!worker_.joinable())
+        worker_ = std::thread(&JitCompiler::run, this);
+    cv_.notify_one();
+    return nullptr;
+}
+
+void JitCompiler::run() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lk(mutex_);
+            cv_.wait(lk, [&] { return stop_ || !jobs_.empty(); });
+            if (stop_) return;
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        auto kernel = build(job);
+        std::lock_guard<std::mutex> lk(mutex_);
+        if (kernel) {
+            cache_[job.key] = { Entry::READY, std::move(kernel), ++useClock_ };
+            if (++loaded_ > maxLoaded_) evictLocked();
+        } else {
+            cache_[job.key] = { Entry::FAILED, nullptr };
+        }
+    }
+}
+
+// Drop the least recently used kernel; networks still running it keep it
+// loaded until they finish. Asked for again, it is simply recompiled.
+void JitCompiler::evictLocked() {
+    auto lru = cache_.end();
+    for (auto it = cache_.begin(); it != cache_.end(); ++it)
+        if (it->second.state == Entry::READY && (lru == cache_.end() || it->second.lastUse < lru->second.lastUse))
+            lru = it;
+    if (lru == cache_.end()) return;
+    cache_.erase(lru);
+    loaded_--;
+}
+
+std::shared_ptr<const JitKernel> JitCompiler::build(const Job& job) {
+#ifdef _WIN32
+    (void)job;
+    return nullptr;
+#else
+    char name[32];
+    std::snprintf(name, sizeof(name), "/k%016llx", (unsigned long long)job.key);
+    std::string cpp = dir_ + name + ".cpp";
+    std::string so  = dir_ + name + ".so";
+    {
+        std::ofstream f(cpp);
+        f << job.source;
+        if (!f) return nullptr;
+    }
+    std::string cmd = cxx_ + " -O2 -shared -fPIC -o '" + so + "' '" + cpp + "' 2>/dev/null";
+    int rc = std::system(cmd.c_str());
+    std::remove(cpp.c_str());
+    if (rc != 0) {
+        std::remove(so.c_str());   // a partial output, if any
+        std::cerr << "JIT: compiling kernel " << (name + 1) << " failed\n";
+        return nullptr;
+    }
+
+    void* handle = dlopen(so.c_str(), RTLD_NOW | RTLD_LOCAL);
+    std::remove(so.c_str());   // the mapping survives the unlink
+    if (!handle) {
+        std::cerr << "JIT: " << dlerror() << "\n";
+        return nullptr;
+    }
+    auto kernel = std::make_shared<JitKernel>();
+    kernel->handle = handle;   // unloaded with the last reference
+    kernel->fn = reinterpret_cast<JitFeedFn>(dlsym(handle, KERNEL_SYMBOL));
+    if (!kernel->fn) return nullptr;
+    return kernel;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// JitNetwork
+// ---------------------------------------------------------------------------
+
+JitNetwork::JitNetwork(const Genome& g, bool request)
+ : genome_(g),
+   fn_(nullptr),
+   waiting_(request && JitCompiler::getInstance().enabled())
+{
+    if (auto kernel = JitCompiler::getInstance().find(g, request))
+        bind(std::move(kernel));
+    else
+        interp_ = std::make_unique<Network>(g);
+}
+
+void JitNetwork::bind(std::shared_ptr<const JitKernel> kernel) {
+    kernel_ = std::move(kernel);
+    fn_ = kernel_->fn;
+    waiting_ = false;
+    ids_.clear();
+    outputs_.clear();
+    inputs_ = 0;
+    for (auto& kv : genome_.nodes) {
+        if (kv.second.type == NodeGene::INPUT)  inputs_++;
+        if (kv.second.type == NodeGene::OUTPUT) outputs_.push_back(ids_.size());
+        ids_.push_back(kv.first);
+    }
+    values_.resize(ids_.size());
+    out_.resize(outputs_.size());
+}
+
+const std::vector<float>& JitNetwork::feed(const float* in, size_t n) {
+    // switch over once the background compile lands (checked sparingly)
+    if (waiting_ && (++feeds_ & 63) == 0)
+        if (auto kernel = JitCompiler::getInstance().find(genome_, false))
+            bind(std::move(kernel));
+    if (!fn_) return interp_->feed(in, n);
+
+    if (n < inputs_) throw std::out_of_range("JitNetwork::feed: too few inputs");
+
+    fn_(in, values_.data());
+    activations_.clear();
+    for (size_t i = 0; i < outputs_.size(); ++i) out_[i] = values_[outputs_[i]];
+    return out_;
+}
+
+const std::unordered_map<NodeId, float>& JitNetwork::getActivations() const {
+    if (!fn_) return interp_->getActivations();
+    if (activations_.empty())
+        for (size_t i = 0; i < ids_.size(); ++i) activations_[ids_[i]] = values_[i];
+    return activations_;
+}
+
+} // namespace neat
@@ -0,0 +1,127 @@
+// NetworkJit.h
+#pragma once
+#include "Genome.h"
+#include "Network.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace neat {
+
+/// Compiled kernel: reads the inputs, writes every node value (dense, in
+/// node-ID order) into values.
+using JitFeedFn = void (*)(const float* in, float* values);
+
+/// A loaded kernel. Its shared object stays mapped while any reference to
+/// it is alive, even after the cache has evicted it.
+struct JitKernel {
+    JitFeedFn fn = nullptr;
+    void* handle = nullptr;
+
+    JitKernel() = default;
+    ~JitKernel();
+    JitKernel(const JitKernel&)            = delete;
+    JitKernel& operator=(const JitKernel&) = delete;
+};
+
+/**
+ * @brief  Native code generation for hot, long-lived networks.
+ *
+ * Emits straight-line C++ for one genome (topology and weights baked in as
+ * constants), compiles it with the system compiler into a shared object on
+ * a background thread and loads it with dlopen. Kernels are cached by
+ * Genome::contentHash() (plus the activation setup), so elites that
+ * survive unchanged reuse theirs. At most SNAKENEAT_JIT_CACHE (default 64)
+ * stay loaded; beyond that the least recently used one is dropped and
+ * unloaded once no network runs it any more.
+ *
+ * Set SNAKENEAT_JIT=0 to disable, SNAKENEAT_JIT_CXX to pick the compiler.
+ * Not available on Windows; find() then always misses.
+ */
+class JitCompiler {
+public:
+    static JitCompiler& getInstance();
+
+    /// Ready kernel for g, or nullptr. With request=true a miss queues a
+    /// background compile (at most one per distinct genome).
+    std::shared_ptr<const JitKernel> find(const Genome& g, bool request);
+
+    bool enabled() const { return enabled_; }
+
+private:
+    JitCompiler();
+    ~JitCompiler();
+    JitCompiler(const JitCompiler&)            = delete;
+    JitCompiler& operator=(const JitCompiler&) = delete;
+
+    struct Entry {
+        enum State { QUEUED, READY, FAILED } state;
+        std::shared_ptr<const JitKernel> kernel;
+        uint64_t lastUse = 0;           // useClock_ at the last hit
+    };
+    struct Job {
+        uint64_t key;
+        std::string source;
+    };
+
+    void run();
+    std::shared_ptr<const JitKernel> build(const Job& job);
+    void evictLocked();
+
+    bool enabled_ = false;
+    std::string cxx_;
+    std::string dir_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::unordered_map<uint64_t, Entry> cache_;
+    std::deque<Job> jobs_;
+    size_t   loaded_    = 0;            // READY entries
+    size_t   maxLoaded_ = 64;
+    uint64_t useClock_  = 0;
+    std::thread worker_;
+    bool stop_ = false;
+};
+
+/// Generate the kernel source for g (exposed for inspection).
+std::string emitNetworkSource(const Genome& g);
+
+/**
+ * @brief  Drop-in replacement for Network that runs a JIT kernel when one
+ *         is ready and falls back to the interpreter otherwise.
+ */
+class JitNetwork {
+public:
+    /// request=true queues compilation if no kernel is cached yet
+    explicit JitNetwork(const Genome& g, bool request = true);
+
+    /// The returned outputs stay valid until the next call.
+    const std::vector<float>& feed(const std::vector<float>& in) { return feed(in.data(), in.size()); }
+    const std::vector<float>& feed(const float* in, size_t n);
+
+    bool compiled() const { return fn_ != nullptr; }
+    const Genome& getGenome() const { return genome_; }
+    const std::unordered_map<NodeId, float>& getActivations() const;
+
+private:
+    void bind(std::shared_ptr<const JitKernel> kernel);
+
+    const Genome& genome_;
+    std::shared_ptr<const JitKernel> kernel_;   // keeps fn_ loaded
+    JitFeedFn fn_;
+    bool     waiting_;                    // compile requested, not landed yet
+    unsigned feeds_ = 0;
+    std::unique_ptr<Network> interp_;     // only built when there is no kernel
+    std::vector<NodeId> ids_;             // dense index → node ID
+    size_t inputs_ = 0;
+    std::vector<size_t> outputs_;         // dense indices of output nodes
+    std::vector<float>  values_;
+    std::vector<float>  out_;
+    mutable std::unordered_map<NodeId, float> activations_;
+};
+
+} // namespace neat
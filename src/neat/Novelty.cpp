@@ -0,0 +1,197 @@
+// Novelty.cpp
+#include "Novelty.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <thread>
+
+namespace neat {
+
+static constexpr uint32_t NO_ID       = std::numeric_limits<uint32_t>::max();
+static constexpr size_t   TAIL_POINTS = 32;   // brute-forced before indexing
+
+// ---------------------------------------------------------------------------
+// KnnHeap
+// ---------------------------------------------------------------------------
+
+void KnnHeap::offer(float dist, uint32_t id) {
+    if (items_.size() < k_) {
+        items_.emplace_back(dist, id);
+        std::push_heap(items_.begin(), items_.end());
+    } else if (k_ > 0 && dist < items_.front().first) {
+        std::pop_heap(items_.begin(), items_.end());
+        items_.back() = { dist, id };
+        std::push_heap(items_.begin(), items_.end());
+    }
+}
+
+float KnnHeap::bound() const {
+    return items_.size() < k_ ? std::numeric_limits<float>::infinity()
+                              : items_.front().first;
+}
+
+float KnnHeap::meanDistance() const {
+    if (items_.empty()) return 0.0f;
+    float sum = 0.0f;
+    for (auto& it : items_) sum += it.first;
+    return sum / items_.size();
+}
+
+// ---------------------------------------------------------------------------
+// VpTree
+// ---------------------------------------------------------------------------
+
+VpTree::VpTree(int dim, std::vector<float> points, std::vector<uint32_t> ids)
+ : dim_(dim), points_(std::move(points)), ids_(std::move(ids))
+{
+    std::vector<uint32_t> rows(ids_.size());
+    std::iota(rows.begin(), rows.end(), 0u);
+    std::vector<float> dist(ids_.size());
+    nodes_.reserve(ids_.size());
+    root_ = build(rows, 0, rows.size(), dist);
+}
+
+float VpTree::distance(const float* a, const float* b) const {
+    float sum = 0.0f;
+    for (int i = 0; i < dim_; ++i) {
+        float d = a[i] - b[i];
+        sum += d * d;
+    }
+    return std::sqrt(sum);
+}
+
+int32_t VpTree::build(std::vector<uint32_t>& rows, size_t lo, size_t hi, std::vector<float>& dist) {
+    if (lo >= hi) return -1;
+
+    // the middle row as vantage point keeps builds deterministic
+    std::swap(rows[lo], rows[lo + (hi - lo) / 2]);
+    int32_t self = int32_t(nodes_.size());
+    nodes_.push_back({ rows[lo], 0.0f, -1, -1 });
+    if (hi - lo == 1) return self;
+
+    const float* vp = &points_[size_t(rows[lo]) * dim_];
+    for (size_t i = lo + 1; i < hi; ++i)
+        dist[rows[i]] = distance(vp, &points_[size_t(rows[i]) * dim_]);
+
+    // split the rest at the median distance: [lo+1, mid) inside, [mid, hi) outside
+    size_t mid = lo + 1 + (hi - lo - 1) / 2;
+    std::nth_element(rows.begin() + lo + 1, rows.begin() + mid, rows.begin() + hi,
+                     [&](uint32_t a, uint32_t b) { return dist[a] < dist[b]; });
+    float radius = dist[rows[mid]];
+
+    int32_t inside  = build(rows, lo + 1, mid, dist);
+    int32_t outside = build(rows, mid, hi, dist);
+    nodes_[self].radius  = radius;
+    nodes_[self].inside  = inside;
+    nodes_[self].outside = outside;
+    return self;
+}
+
+void VpTree::search(const float* q, uint32_t exclude, KnnHeap& heap) const {
+    if (root_ >= 0) search(root_, q, exclude, heap);
+}
+
+void VpTree::search(int32_t n, const float* q, uint32_t exclude, KnnHeap& heap) const {
+    const Node& node = nodes_[n];
+    float d = distance(q, &points_[size_t(node.point) * dim_]);
+    if (ids_[node.point] != exclude) heap.offer(d, ids_[node.point]);
+
+    // inside holds points within radius of the vantage point, outside the
+    // rest; visit the likelier side first so the bound shrinks early
+    if (d < node.radius) {
+        if (node.inside  >= 0 && d - heap.bound() <= node.radius) search(node.inside,  q, exclude, heap);
+        if (node.outside >= 0 && d + heap.bound() >= node.radius) search(node.outside, q, exclude, heap);
+    } else {
+        if (node.outside >= 0 && d + heap.bound() >= node.radius) search(node.outside, q, exclude, heap);
+        if (node.inside  >= 0 && d - heap.bound() <= node.radius) search(node.inside,  q, exclude, heap);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// NoveltyArchive
+// ---------------------------------------------------------------------------
+
+NoveltyArchive::NoveltyArchive(int dim, int k, int addPerGeneration)
+ : dim_(dim), k_(std::max(1, k)), addPerGen_(std::max(0, addPerGeneration))
+{}
+
+// run fn(i) for i in [0, n), split over hardware threads when worth it
+template<typename F>
+static void parallelFor(size_t n, F fn) {
+    size_t threads = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), n / 32);
+    if (threads <= 1) {
+        for (size_t i = 0; i < n; ++i) fn(i);
+        return;
+    }
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < threads; ++t)
+        pool.emplace_back([&, t] {
+            for (size_t i = t; i < n; i += threads) fn(i);
+        });
+    for (auto& th : pool) th.join();
+}
+
+std::vector<float> NoveltyArchive::score(const std::vector<std::vector<float>>& behaviors) const {
+    // index the batch itself; ids are positions so each query can skip itself
+    std::vector<float> flat;
+    flat.reserve(behaviors.size() * dim_);
+    for (const auto& b : behaviors) flat.insert(flat.end(), b.begin(), b.begin() + dim_);
+    std::vector<uint32_t> ids(behaviors.size());
+    std::iota(ids.begin(), ids.end(), 0u);
+    VpTree batch(dim_, std::move(flat), std::move(ids));
+
+    std::vector<float> novelty(behaviors.size());
+    parallelFor(behaviors.size(), [&](size_t i) {
+        const float* q = behaviors[i].data();
+        KnnHeap heap(k_);
+        batch.search(q, uint32_t(i), heap);
+        for (const auto& tree : trees_) tree->search(q, NO_ID, heap);
+        for (size_t row = 0; row * dim_ < tail_.size(); ++row) {
+            float sum = 0.0f;
+            for (int j = 0; j < dim_; ++j) {
+                float d = q[j] - tail_[row * dim_ + j];
+                sum += d * d;
+            }
+            heap.offer(std::sqrt(sum), NO_ID);
+        }
+        novelty[i] = heap.meanDistance();
+    });
+    return novelty;
+}
+
+int NoveltyArchive::update(const std::vector<std::vector<float>>& behaviors,
+                           const std::vector<float>& novelty) {
+    std::vector<size_t> order(behaviors.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return novelty[a] > novelty[b]; });
+
+    int added = 0;
+    for (size_t i : order) {
+        if (added >= addPerGen_ || novelty[i] <= 0.0f) break;
+        insert(behaviors[i].data());
+        added++;
+    }
+    return added;
+}
+
+void NoveltyArchive::insert(const float* b) {
+    tail_.insert(tail_.end(), b, b + dim_);
+    count_++;
+    if (tail_.size() < TAIL_POINTS * dim_) return;
+
+    // merge the tail with every tree no larger than the result (binary counter)
+    std::vector<float> points;
+    points.swap(tail_);
+    while (!trees_.empty() && trees_.back()->size() * dim_ <= points.size()) {
+        const auto& pts = trees_.back()->points();
+        points.insert(points.end(), pts.begin(), pts.end());
+        trees_.pop_back();
+    }
+    size_t n = points.size() / dim_;
+    std::vector<uint32_t> ids(n);
+    std::iota(ids.begin(), ids.end(), uint32_t(count_ - n));
+    trees_.push_back(std::make_unique<VpTree>(dim_, std::move(points), std::move(ids)));
+}
+
+} // namespace neat
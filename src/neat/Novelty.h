@@ -0,0 +1,99 @@
+// Novelty.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace neat {
+
+/// Bounded max-heap of the k nearest (distance, id) pairs found so far.
+class KnnHeap {
+public:
+    explicit KnnHeap(size_t k) : k_(k) { items_.reserve(k); }
+
+    void offer(float dist, uint32_t id);
+    /// Current search radius: distance of the k-th best, or +inf.
+    float bound() const;
+    size_t size() const { return items_.size(); }
+    float meanDistance() const;
+
+private:
+    size_t k_;
+    std::vector<std::pair<float, uint32_t>> items_;
+};
+
+/**
+ * @brief  Vantage-point tree over fixed-dimension points (Euclidean).
+ *
+ * Static once built; NoveltyArchive keeps several of them to support
+ * insertion. A search visits a subtree only if the ball of the current
+ * k-th neighbour crosses its shell, which on behavior data prunes most of
+ * the tree.
+ */
+class VpTree {
+public:
+    /// points: ids.size() * dim floats, row-major
+    VpTree(int dim, std::vector<float> points, std::vector<uint32_t> ids);
+
+    size_t size() const { return ids_.size(); }
+    const std::vector<float>&    points() const { return points_; }
+    const std::vector<uint32_t>& ids()    const { return ids_; }
+
+    /// Offer the neighbours of q to heap, skipping the point with id exclude.
+    void search(const float* q, uint32_t exclude, KnnHeap& heap) const;
+
+private:
+    struct Node {
+        uint32_t point;          // row in points_
+        float    radius;         // median distance from the vantage point
+        int32_t  inside, outside;
+    };
+
+    int32_t build(std::vector<uint32_t>& rows, size_t lo, size_t hi, std::vector<float>& dist);
+    void    search(int32_t node, const float* q, uint32_t exclude, KnnHeap& heap) const;
+    float   distance(const float* a, const float* b) const;
+
+    int dim_;
+    std::vector<float>    points_;
+    std::vector<uint32_t> ids_;
+    std::vector<Node>     nodes_;
+    int32_t root_ = -1;
+};
+
+/**
+ * @brief  Novelty search: an archive of past behaviors with a kNN index.
+ *
+ * Novelty of a behavior is its mean distance to the k nearest behaviors
+ * among the archive and the rest of the current population. The archive
+ * is indexed with the logarithmic method: new behaviors collect in a small
+ * brute-force tail, and a full tail is merged with every smaller tree into
+ * a single new VpTree, so each point is rebuilt O(log n) times in total.
+ * Queries for a whole population run in parallel.
+ */
+class NoveltyArchive {
+public:
+    NoveltyArchive(int dim, int k = 15, int addPerGeneration = 4);
+
+    /// Novelty of each behavior (each of dim() values) against the archive
+    /// and the other behaviors of the same batch.
+    std::vector<float> score(const std::vector<std::vector<float>>& behaviors) const;
+
+    /// Archive the most novel behaviors of a generation. Returns #added.
+    int update(const std::vector<std::vector<float>>& behaviors,
+               const std::vector<float>& novelty);
+
+    int    dim()  const { return dim_; }
+    size_t size() const { return count_; }
+
+private:
+    void insert(const float* b);
+
+    int dim_, k_, addPerGen_;
+    std::vector<std::unique_ptr<VpTree>> trees_;   // sizes decreasing
+    std::vector<float> tail_;                      // not yet indexed
+    size_t count_ = 0;
+};
+
+} // namespace neat
@@ -0,0 +1,62 @@
+// PackedGenome.cpp
+#include "PackedGenome.h"
+
+namespace neat {
+
+bool PackedGenome::pack(const Genome& g, int inN, int outN, PackedGenome& out) {
+    if (inN < 0 || outN < 0 || inN > 0xffff || outN > 0xffff) return false;
+
+    // every fixed node must be present with the type its ID implies
+    auto impliedType = [&](NodeId id) {
+        if (id < NodeId(inN))         return NodeGene::INPUT;
+        if (id == NodeId(inN))        return NodeGene::BIAS;
+        if (id <= NodeId(inN + outN)) return NodeGene::OUTPUT;
+        return NodeGene::HIDDEN;
+    };
+    PackedGenome p;
+    p.inN_  = uint16_t(inN);
+    p.outN_ = uint16_t(outN);
+    size_t fixed = 0;
+    for (auto& kv : g.nodes) {
+        if (kv.second.id != kv.first || kv.second.type != impliedType(kv.first)) return false;
+        if (kv.second.type == NodeGene::HIDDEN) p.hidden_.push_back(kv.first);
+        else fixed++;
+    }
+    if (fixed != size_t(inN + 1 + outN)) return false;
+
+    p.connections_ = g.connections;
+    p.fitness = g.fitness;
+    p.novelty = g.novelty;
+    p.stats   = g.stats;
+    p.lineage = g.lineage;
+    out = std::move(p);
+    return true;
+}
+
+Genome PackedGenome::unpack() const {
+    Genome g;
+    g.fitness = fitness;
+    g.novelty = novelty;
+    g.stats   = stats;
+    g.lineage = lineage;
+
+    // sorted keys: hinting at end() makes each insertion O(1)
+    NodeId fixedEnd = NodeId(inN_) + 1 + outN_;
+    for (NodeId id = 0; id < fixedEnd; ++id) {
+        NodeGene::Type type = id < inN_  ? NodeGene::INPUT
+                            : id == inN_ ? NodeGene::BIAS : NodeGene::OUTPUT;
+        g.nodes.emplace_hint(g.nodes.end(), id, NodeGene{ id, type });
+    }
+    for (NodeId id : hidden_)
+        g.nodes.emplace_hint(g.nodes.end(), id, NodeGene{ id, NodeGene::HIDDEN });
+
+    g.connections = connections_;
+    return g;
+}
+
+size_t PackedGenome::bytes() const {
+    return sizeof(*this) + hidden_.capacity() * sizeof(NodeId)
+                         + connections_.bytes() - sizeof(connections_);
+}
+
+} // namespace neat
@@ -0,0 +1,51 @@
+// PackedGenome.h
+#pragma once
+#include "Genome.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace neat {
+
+/**
+ * @brief  Compact in-process form of a genome, for keeping many at rest.
+ *
+ * A Genome's connections are already in packed form (ConnectionTable.h):
+ * an interned Topology plus a weight array and enabled flags. What is
+ * left is the node std::map, roughly 50 bytes per node once allocator
+ * overhead is counted, which a PackedGenome replaces with a sorted array
+ * of hidden node IDs. Packing shares the genome's topology, so it never
+ * hashes or copies structure.
+ *
+ * Only genomes with the standard node layout can be packed. Innovation
+ * numbers are process-local, so this is not a wire or file format (see
+ * GenomeIO for that).
+ */
+class PackedGenome {
+public:
+    /// Pack g; false (and out untouched) if g does not fit the encoding.
+    static bool pack(const Genome& g, int inN, int outN, PackedGenome& out);
+
+    /// Rebuild the full genome.
+    Genome unpack() const;
+
+    const Topology& topology() const { return *connections_.topology(); }
+    size_t connectionCount() const { return connections_.size(); }
+    /// Bytes owned by this genome (the shared topology not included).
+    size_t bytes() const;
+
+    // carried over unchanged, like Genome's
+    float fitness = 0.0f;
+    float novelty = 0.0f;
+    FitnessStats stats;
+    Lineage lineage;
+
+private:
+    // input, bias and output nodes are implied by the standard ID layout
+    // (inputs [0, inN), bias inN, outputs inN+1 .. inN+outN)
+    uint16_t inN_ = 0, outN_ = 0;
+    std::vector<NodeId> hidden_;       // ascending
+    ConnectionTable connections_;
+};
+
+} // namespace neat
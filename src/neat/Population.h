@@ -0,0 +1,81 @@
+// Population.h
+#pragma once
+#include "Genome.h"
+#include <cstdint>
+#include <vector>
+
+namespace neat {
+
+/**
+ * @brief  One generation's genomes and their per-genome columns, by dense
+ *         index.
+ *
+ * Selection, fitness sharing and stagnation work on the contiguous columns
+ * instead of chasing Genome pointers. Species refer to their members as a
+ * range [first, first + count) of `members`, a permutation of the genome
+ * indices grouped by species, so replacing a genome (immigrate) never
+ * leaves a species pointing at a deleted one. Genomes are owned by NEAT.
+ */
+struct Population {
+    static constexpr uint32_t NO_SPECIES = UINT32_MAX;
+
+    std::vector<Genome*>  genomes;
+    std::vector<float>    fitness;     // copied from the genomes by gather();
+                                       // the selection score with novelty on
+    std::vector<float>    adjusted;    // fitness shared within its species
+    std::vector<uint32_t> species;     // index into NEAT::species(), or NO_SPECIES
+    std::vector<uint32_t> size;        // connection genes
+    std::vector<uint32_t> age;         // generations carried over as an elite
+    std::vector<uint32_t> members;     // genome indices, grouped by species
+
+    size_t count() const { return genomes.size(); }
+
+    void reserve(size_t n) {
+        genomes.reserve(n);
+        fitness.reserve(n);
+        adjusted.reserve(n);
+        species.reserve(n);
+        size.reserve(n);
+        age.reserve(n);
+        members.reserve(n);
+    }
+
+    // Append g (not yet in a species); returns its index
+    uint32_t push(Genome* g, uint32_t genomeAge = 0) {
+        genomes.push_back(g);
+        fitness.push_back(g->fitness);
+        adjusted.push_back(0.0f);
+        species.push_back(NO_SPECIES);
+        size.push_back(uint32_t(g->connections.size()));
+        age.push_back(genomeAge);
+        return uint32_t(genomes.size() - 1);
+    }
+
+    // Put g at index i in place of the genome there (which the caller frees)
+    void replace(uint32_t i, Genome* g) {
+        genomes[i] = g;
+        fitness[i] = g->fitness;
+        size[i]    = uint32_t(g->connections.size());
+        age[i]     = 0;
+    }
+
+    // Refresh the columns that evaluation and mutation change
+    void gather() {
+        for (size_t i = 0; i < genomes.size(); ++i) {
+            fitness[i] = genomes[i]->fitness;
+            size[i]    = uint32_t(genomes[i]->connections.size());
+        }
+    }
+
+    void clear() {
+        genomes.clear();
+        fitness.clear();
+        adjusted.clear();
+        species.clear();
+        size.clear();
+        age.clear();
+        members.clear();
+    }
+};
+
+} // namespace neat
@@ -0,0 +1,137 @@
+// QuantizedNetwork.cpp
+#include "QuantizedNetwork.h"
+#include "Activation.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+using namespace neat;
+
+// Q7.8 fixed point for node values: 1.0 == 256
+static constexpr float  ACT_ONE   = 256.0f;
+static constexpr int32_t ACT_MAX  = 32767;
+
+// tanh table over [-8, 8) in steps of 1/128, indexed straight from Q7.8
+static constexpr int TANH_LUT_SIZE = 2048;
+
+static const float* tanhTable() {
+    static const auto table = [] {
+        std::vector<float> t(TANH_LUT_SIZE);
+        for (int i = 0; i < TANH_LUT_SIZE; ++i)
+            t[i] = std::tanh((i - TANH_LUT_SIZE / 2 + 0.5f) / 128.0f);
+        return t;
+    }();
+    return table.data();
+}
+
+static inline int16_t saturate16(float v) {
+    long q = std::lrint(v);
+    return int16_t(std::clamp<long>(q, -ACT_MAX, ACT_MAX));
+}
+
+QuantizedNetwork::QuantizedNetwork(const Genome& g) {
+    if (g.nodes.size() > 65535)
+        throw std::length_error("QuantizedNetwork: too many nodes for 16-bit indices");
+
+    // dense slots in node-ID order, like Network::feed
+    std::unordered_map<NodeId, uint16_t> slot;
+    for (auto& kv : g.nodes) {
+        uint16_t i = uint16_t(slot.size());
+        slot.emplace(kv.first, i);
+        if (kv.second.type == NodeGene::INPUT)  inputs_.push_back(i);
+    }
+    act_.assign(slot.size(), 0);
+    for (auto& kv : g.nodes)
+        if (kv.second.type == NodeGene::BIAS) act_[slot[kv.first]] = int16_t(ACT_ONE);
+
+    // Network::feed pushes each node's value along its out-edges in
+    // topological order. Pulling over in-edges from nodes that come earlier
+    // in that order is the same computation.
+    Network ref(g);
+    std::unordered_map<NodeId, size_t> rank;
+    for (NodeId id : ref.order()) rank.emplace(id, rank.size());
+
+    std::unordered_map<NodeId, std::vector<ConnectionGene>> incoming;
+    for (const auto& kv : g.connections) {
+        const auto& cg = kv.second;
+        if (cg.enabled && rank.count(cg.from) && slot.count(cg.to))
+            incoming[cg.to].push_back(cg);
+    }
+
+    // evaluation order: ranked nodes first, then nodes caught in a cycle
+    // (they still collect input, like in the interpreter)
+    std::vector<NodeId> evalOrder;
+    for (NodeId id : ref.order()) {
+        auto type = g.nodes.at(id).type;
+        if (type != NodeGene::INPUT && type != NodeGene::BIAS) evalOrder.push_back(id);
+    }
+    for (auto& kv : g.nodes)
+        if (!rank.count(kv.first) && incoming.count(kv.first)) evalOrder.push_back(kv.first);
+
+    for (NodeId id : evalOrder) {
+        const auto& in = incoming[id];
+        float maxW = 0.0f;
+        for (const auto& cg : in) maxW = std::max(maxW, std::fabs(cg.weight));
+        float scale = maxW > 0.0f ? maxW / 127.0f : 1.0f;
+
+        nodes_.push_back({ slot[id], uint32_t(edgeW_.size()), scale });
+        for (const auto& cg : in) {
+            edgeSrc_.push_back(slot[cg.from]);
+            edgeW_.push_back(int8_t(std::lrint(cg.weight / scale)));
+        }
+    }
+    nodes_.push_back({ 0, uint32_t(edgeW_.size()), 0.0f });   // sentinel
+
+    // outputs outside the topological order are never squashed by the interpreter
+    for (auto& kv : g.nodes)
+        if (kv.second.type == NodeGene::OUTPUT)
+            outputs_.push_back({ slot[kv.first], rank.count(kv.first) > 0 });
+    out_.resize(outputs_.size());
+}
+
+const std::vector<float>& QuantizedNetwork::feed(const float* in, size_t n) {
+    if (n < inputs_.size())
+        throw std::out_of_range("QuantizedNetwork::feed: too few inputs");
+    for (size_t i = 0; i < inputs_.size(); ++i)
+        act_[inputs_[i]] = saturate16(in[i] * ACT_ONE);
+
+    // integer multiply-accumulate over each node's contiguous in-edges
+    const uint16_t* src = edgeSrc_.data();
+    const int8_t*   w   = edgeW_.data();
+    const int16_t*  a   = act_.data();
+    for (size_t n = 0; n + 1 < nodes_.size(); ++n) {
+        int32_t acc = 0;
+        for (uint32_t e = nodes_[n].firstEdge; e < nodes_[n + 1].firstEdge; ++e)
+            acc += int32_t(w[e]) * int32_t(a[src[e]]);
+        act_[nodes_[n].index] = saturate16(float(acc) * nodes_[n].requant);
+    }
+
+    // any tanh flavour comes from the table, other activations are computed
+    const float* lut = tanhTable();
+    Activation fn = activationFor(NodeGene::OUTPUT);
+    bool tanhLike = fn == Activation::TANH || fn == Activation::FAST_TANH ||
+                    fn == Activation::LUT_TANH;
+    for (size_t i = 0; i < outputs_.size(); ++i) {
+        int16_t v = act_[outputs_[i].index];
+        if (!outputs_[i].squash) {
+            out_[i] = v / ACT_ONE;
+        } else if (tanhLike) {
+            int idx = std::clamp((v >> 1) + TANH_LUT_SIZE / 2, 0, TANH_LUT_SIZE - 1);
+            out_[i] = lut[idx];
+        } else {
+            out_[i] = activate(fn, v / ACT_ONE);
+        }
+    }
+    return out_;
+}
+
+const std::vector<float>& QuantizationCheck::feed(const float* in, size_t n) {
+    const auto& ref = ref_.feed(in, n);
+    const auto& out = quant_.feed(in, n);
+    auto argmax = [](const std::vector<float>& v) {
+        return std::distance(v.begin(), std::max_element(v.begin(), v.end()));
+    };
+    decisions_++;
+    if (argmax(ref) != argmax(out)) disagreements_++;
+    return out;
+}
@@ -0,0 +1,78 @@
+// QuantizedNetwork.h
+#pragma once
+#include "Genome.h"
+#include "Network.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace neat {
+
+/**
+ * @brief  Int8 inference path for evaluation.
+ *
+ * Weights are stored as int8 with one scale per destination node, node
+ * values travel as int16 fixed point (Q7.8, saturating) and accumulate in
+ * int32. The graph is flattened into a compact pull-style edge list
+ * (3 bytes per edge) walked in the same order as Network::feed. Output
+ * activations come from a 2048-entry tanh table (computed directly when
+ * the output activation is not a tanh).
+ *
+ * The policy only looks at the argmax of the outputs, so small rounding
+ * differences rarely change a decision; QuantizationCheck measures how
+ * often they do.
+ */
+class QuantizedNetwork {
+public:
+    explicit QuantizedNetwork(const Genome& g);
+
+    /// The returned outputs stay valid until the next call.
+    const std::vector<float>& feed(const std::vector<float>& in) { return feed(in.data(), in.size()); }
+    const std::vector<float>& feed(const float* in, size_t n);
+
+    size_t edgeCount() const { return edgeW_.size(); }
+
+private:
+    struct Node {
+        uint16_t index;        // dense slot in act_
+        uint32_t firstEdge;    // incoming edges [firstEdge, next node's firstEdge)
+        float    requant;      // weight scale, maps the accumulator back to Q7.8
+    };
+
+    struct Output {
+        uint16_t index;
+        bool     squash;       // false if the interpreter never reaches it
+    };
+
+    std::vector<uint16_t> inputs_;     // dense slots of input nodes, in input order
+    std::vector<Output>   outputs_;
+    std::vector<Node>     nodes_;      // non-input nodes in evaluation order (+ sentinel)
+    std::vector<uint16_t> edgeSrc_;
+    std::vector<int8_t>   edgeW_;
+    std::vector<int16_t>  act_;
+    std::vector<float>    out_;
+};
+
+/**
+ * @brief  Validation hook: plays with the quantized network while shadowing
+ *         the float one, counting decisions on which their argmax differs.
+ *         Usable anywhere a network is, e.g. Game::evaluate.
+ */
+class QuantizationCheck {
+public:
+    explicit QuantizationCheck(const Genome& g) : ref_(g), quant_(g) {}
+
+    const std::vector<float>& feed(const std::vector<float>& in) { return feed(in.data(), in.size()); }
+    const std::vector<float>& feed(const float* in, size_t n);
+
+    size_t decisions()     const { return decisions_; }
+    size_t disagreements() const { return disagreements_; }
+
+private:
+    Network          ref_;
+    QuantizedNetwork quant_;
+    size_t decisions_     = 0;
+    size_t disagreements_ = 0;
+};
+
+} // namespace neat
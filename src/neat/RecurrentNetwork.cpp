@@ -0,0 +1,78 @@
+// RecurrentNetwork.cpp
+#include "RecurrentNetwork.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace neat {
+
+RecurrentNetwork::RecurrentNetwork(const Genome& g)
+ : genome_(g)
+{
+    std::unordered_map<NodeId, uint32_t> slot;
+    for (auto& kv : g.nodes) {
+        uint32_t i = uint32_t(ids_.size());
+        slot.emplace(kv.first, i);
+        ids_.push_back(kv.first);
+        switch (kv.second.type) {
+            case NodeGene::INPUT:  inputs_.push_back(i); break;
+            case NodeGene::BIAS:   bias_.push_back(i); break;
+            case NodeGene::OUTPUT: outputSlots_.push_back(i); break;
+            case NodeGene::HIDDEN: break;
+        }
+    }
+
+    // enabled in-edges grouped by destination
+    std::unordered_map<NodeId, std::vector<ConnectionGene>> incoming;
+    for (const auto& kv : g.connections) {
+        const auto& cg = kv.second;
+        if (cg.enabled && slot.count(cg.from) && slot.count(cg.to))
+            incoming[cg.to].push_back(cg);
+    }
+
+    for (auto& kv : g.nodes) {
+        auto type = kv.second.type;
+        if (type != NodeGene::HIDDEN && type != NodeGene::OUTPUT) continue;
+        nodes_.push_back({ slot[kv.first], uint32_t(edgeW_.size()), true, activationFor(type) });
+        for (const auto& cg : incoming[kv.first]) {
+            edgeSrc_.push_back(slot[cg.from]);
+            edgeW_.push_back(cg.weight);
+        }
+    }
+    nodes_.push_back({ 0, uint32_t(edgeW_.size()), false, Activation::LINEAR });   // sentinel
+
+    state_.resize(ids_.size());
+    next_.resize(ids_.size());
+    out_.resize(outputSlots_.size());
+    reset();
+}
+
+void RecurrentNetwork::reset() {
+    std::fill(state_.begin(), state_.end(), 0.0f);
+    for (uint32_t b : bias_) state_[b] = 1.0f;
+    next_ = state_;
+}
+
+const std::vector<float>& RecurrentNetwork::feed(const float* in, size_t n) {
+    if (n < inputs_.size())
+        throw std::out_of_range("RecurrentNetwork::feed: too few inputs");
+    for (size_t i = 0; i < inputs_.size(); ++i) state_[inputs_[i]] = in[i];
+
+    // synchronous update: read state_, write next_
+    cpu::kernels().pullProgram(nodes_.data(), nodes_.size() - 1, edgeSrc_.data(), edgeW_.data(),
+                               state_.data(), next_.data());
+    // inputs and bias are not computed; carry them over before the swap
+    for (uint32_t i : inputs_) next_[i] = state_[i];
+    state_.swap(next_);
+
+    for (size_t i = 0; i < outputSlots_.size(); ++i) out_[i] = state_[outputSlots_[i]];
+    activations_.clear();
+    return out_;
+}
+
+const std::unordered_map<NodeId, float>& RecurrentNetwork::getActivations() const {
+    if (activations_.empty())
+        for (size_t i = 0; i < ids_.size(); ++i) activations_[ids_[i]] = state_[i];
+    return activations_;
+}
+
+} // namespace neat
@@ -0,0 +1,56 @@
+// RecurrentNetwork.h
+#pragma once
+#include "Activation.h"
+#include "Genome.h"
+#include "cpu/Dispatch.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace neat {
+
+/**
+ * @brief  Executor for genomes with recurrent connections.
+ *
+ * Every feed() is one synchronous tick: each hidden/output node takes the
+ * weighted sum of *last tick's* node values over its enabled in-edges and
+ * applies its activation. Cycles (including self-loops) therefore just
+ * carry state from tick to tick, where Network would drop them; a signal
+ * needs one tick per layer to cross a feedforward path. Unlike Network,
+ * edges carry the *activated* value of their source, which keeps loops
+ * with large weights bounded.
+ *
+ * State lives in two dense arrays in node-ID order; edges are a flat
+ * pull-style list. feed() does not allocate and reset() is one fill, so
+ * Game::evaluate resets it at the start of every episode.
+ */
+class RecurrentNetwork {
+public:
+    explicit RecurrentNetwork(const Genome& g);
+
+    /// One tick. The returned outputs stay valid until the next call.
+    const std::vector<float>& feed(const std::vector<float>& in) { return feed(in.data(), in.size()); }
+    const std::vector<float>& feed(const float* in, size_t n);
+
+    /// Forget all state (start of an episode).
+    void reset();
+
+    const Genome& getGenome() const { return genome_; }
+    const std::unordered_map<NodeId, float>& getActivations() const;
+
+private:
+    const Genome& genome_;
+    std::vector<NodeId>   ids_;        // slot → node ID
+    std::vector<uint32_t> inputs_;     // slots of input nodes, in input order
+    std::vector<uint32_t> bias_;
+    std::vector<uint32_t> outputSlots_;
+    std::vector<cpu::NetStep> nodes_;  // hidden + output nodes (+ sentinel), in-edges
+    std::vector<uint32_t> edgeSrc_;
+    std::vector<float>    edgeW_;
+    std::vector<float>    state_, next_;
+    std::vector<float>    out_;
+    mutable std::unordered_map<NodeId, float> activations_;
+};
+
+} // namespace neat
@@ -1,14 +1,14 @@
 // Species.h
 #pragma once
-#include "Genome.h"
-#include <vector>
+#include <cstdint>
 #include <limits>
 
 namespace neat {
 
 struct Species {
-    Genome*   representative = nullptr;   // chosen at start of each generation
-    std::vector<Genome*> members;
+    uint32_t  id = 0;                      // unique within a NEAT instance
+    uint32_t  representative = 0;         // population index, chosen each generation
+    uint32_t  first = 0, count = 0;       // members: Population::members[first, first+count)
     
     // stagnation tracking:
     float bestFitnessEver = -std::numeric_limits<float>::infinity();
@@ -19,7 +19,7 @@ struct Species {
 
     // call at start of speciation pass
     void resetForNextGen() {
-        members.clear();
+        count = 0;
         adjustedFitnessSum = 0.0;
     }
 };
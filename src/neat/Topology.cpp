@@ -0,0 +1,64 @@
+// Topology.cpp
+#include "Topology.h"
+#include <algorithm>
+
+namespace neat {
+
+uint64_t Topology::geneHash(InnovId innov, NodeId from, NodeId to) {
+    // splitmix64 finalizer (as in Genome.cpp)
+    uint64_t v = (innov ^ (uint64_t(from) << 32) ^ to) + 0x9e3779b97f4a7c15ull;
+    v = (v ^ (v >> 30)) * 0xbf58476d1ce4e5b9ull;
+    v = (v ^ (v >> 27)) * 0x94d049bb133111ebull;
+    return v ^ (v >> 31);
+}
+
+size_t Topology::find(InnovId k) const {
+    auto it = std::lower_bound(innov.begin(), innov.end(), k);
+    return it != innov.end() && *it == k ? size_t(it - innov.begin()) : innov.size();
+}
+
+bool Topology::sameStructure(const Topology& o) const {
+    return innov == o.innov && from == o.from && to == o.to;
+}
+
+size_t Topology::bytes() const {
+    return sizeof(*this) + innov.capacity() * sizeof(InnovId)
+         + (from.capacity() + to.capacity()) * sizeof(NodeId);
+}
+
+TopologyPool& TopologyPool::getInstance() {
+    static TopologyPool inst;
+    return inst;
+}
+
+std::shared_ptr<const Topology> TopologyPool::intern(Topology&& t) {
+    std::lock_guard<std::mutex> lk(mutex_);
+    auto range = table_.equal_range(t.hash);
+    for (auto it = range.first; it != range.second; ++it)
+        if (auto live = it->second.lock())
+            if (live->sameStructure(t)) return live;
+
+    auto shared = std::make_shared<const Topology>(std::move(t));
+    table_.emplace(shared->hash, shared);
+    if (++sinceSweep_ >= 1024) purgeExpired();
+    return shared;
+}
+
+const std::shared_ptr<const Topology>& TopologyPool::empty() {
+    static const std::shared_ptr<const Topology> none = std::make_shared<const Topology>();
+    return none;
+}
+
+size_t TopologyPool::size() {
+    std::lock_guard<std::mutex> lk(mutex_);
+    purgeExpired();
+    return table_.size();
+}
+
+void TopologyPool::purgeExpired() {
+    for (auto it = table_.begin(); it != table_.end();)
+        it = it->second.expired() ? table_.erase(it) : std::next(it);
+    sinceSweep_ = 0;
+}
+
+} // namespace neat
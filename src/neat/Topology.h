@@ -0,0 +1,66 @@
+// Topology.h
+#pragma once
+#include "Gene.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace neat {
+
+/**
+ * @brief  Immutable connection structure, shared by every genome with it.
+ *
+ * Innovation numbers and endpoints, in innovation order. Weights and
+ * whether a connection is enabled are per genome (ConnectionTable.h), not
+ * part of the topology.
+ */
+struct Topology {
+    std::vector<InnovId> innov;      // ascending
+    std::vector<NodeId>  from, to;   // endpoints, parallel to innov
+    uint64_t hash = 0;               // sum of geneHash() over the genes
+
+    /// Hash of one gene. Summed, so adding or removing a gene updates a
+    /// topology's hash without walking the rest.
+    static uint64_t geneHash(InnovId innov, NodeId from, NodeId to);
+
+    size_t size() const { return innov.size(); }
+    /// Position of innovation k, or size() if it is not part of this topology.
+    size_t find(InnovId k) const;
+    bool sameStructure(const Topology& o) const;
+    size_t bytes() const;
+};
+
+/**
+ * @brief  Interns topologies: equal structures map to one shared object,
+ *         released when the last genome using it goes away.
+ */
+class TopologyPool {
+public:
+    static TopologyPool& getInstance();
+
+    /// The shared topology equal to t (whose hash must be set), created
+    /// if needed.
+    std::shared_ptr<const Topology> intern(Topology&& t);
+
+    /// The topology without connections.
+    static const std::shared_ptr<const Topology>& empty();
+
+    /// Distinct topologies currently alive.
+    size_t size();
+
+private:
+    TopologyPool() = default;
+    TopologyPool(const TopologyPool&)            = delete;
+    TopologyPool& operator=(const TopologyPool&) = delete;
+
+    void purgeExpired();
+
+    std::mutex mutex_;
+    std::unordered_multimap<uint64_t, std::weak_ptr<const Topology>> table_;
+    size_t sinceSweep_ = 0;
+};
+
+} // namespace neat
@@ -0,0 +1,69 @@
+// ChampionFormat.h
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+namespace player {
+
+/**
+ * On-disk layout of an exported champion (".snch"): a compiled network
+ * that can be mapped and run in place, with no parsing. Written by
+ * neat::exportChampion(), read by ChampionModel. Host byte order.
+ *
+ *   ChampionHeader
+ *   float         init[nodes]          value of every node before a tick
+ *                                      (1 for bias, 0 otherwise)
+ *   uint32_t      inputIndex[inputs]   node slot of each input, in order
+ *   uint32_t      outputIndex[outputs] node slot of each output, in order
+ *   ChampionStep  steps[steps + 1]     last one is a sentinel (firstEdge)
+ *   ChampionEdge  edges[edges]
+ *
+ * Every array starts on an 8-byte boundary at the offset in the header.
+ *
+ * Feedforward champions (mode PUSH) run exactly like neat::Network: for
+ * each step in order, node's value is added along its out-edges, then the
+ * node is activated. Recurrent champions (mode PULL) run like
+ * neat::RecurrentNetwork: every step sums its in-edges over the previous
+ * tick's values, all steps update at once, and state persists across
+ * ticks until reset.
+ */
+constexpr uint32_t CHAMPION_MAGIC   = 0x48434e53;   // "SNCH"
+constexpr uint32_t CHAMPION_VERSION = 1;
+
+enum ChampionMode : uint8_t { PUSH = 0, PULL = 1 };
+
+/// Activation codes match neat::Activation; NONE leaves the value as is.
+constexpr uint8_t CHAMPION_ACT_NONE = 0xFF;
+
+struct ChampionHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t fileBytes;
+    uint32_t inputs, outputs, nodes, steps, edges;
+    uint8_t  mode;
+    uint8_t  reserved[7];
+    uint64_t sourceHash;            // Genome::contentHash() of the champion
+    uint32_t initOffset, inputOffset, outputOffset, stepOffset, edgeOffset;
+    uint32_t reserved2;
+};
+
+struct ChampionStep {
+    uint32_t node;                  // slot
+    uint32_t firstEdge;             // edges [firstEdge, next step's firstEdge)
+    uint8_t  activation;            // neat::Activation or CHAMPION_ACT_NONE
+    uint8_t  reserved[3];
+};
+
+struct ChampionEdge {
+    uint32_t node;                  // PUSH: destination, PULL: source
+    float    weight;
+};
+
+static_assert(sizeof(ChampionHeader) == 72, "on-disk layout");
+static_assert(sizeof(ChampionStep)   == 12, "on-disk layout");
+static_assert(sizeof(ChampionEdge)   == 8,  "on-disk layout");
+static_assert(std::is_trivially_copyable<ChampionHeader>::value, "written raw");
+
+inline uint32_t championAlign(uint32_t n) { return (n + 7u) & ~7u; }
+
+} // namespace player
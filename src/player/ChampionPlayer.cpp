@@ -0,0 +1,182 @@
+// ChampionPlayer.cpp
+#include "ChampionPlayer.h"
+#include "neat/Activation.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace player {
+
+static bool fail(std::string* error, const std::string& why) {
+    if (error) *error = why;
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// ChampionModel
+// ---------------------------------------------------------------------------
+
+std::unique_ptr<ChampionModel> ChampionModel::load(const std::string& path, std::string* error) {
+    std::unique_ptr<ChampionModel> m(new ChampionModel());
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fail(error, "cannot open " + path);
+        return nullptr;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        fail(error, path + " is empty");
+        return nullptr;
+    }
+    void* base = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // the mapping stays valid
+    if (base == MAP_FAILED) {
+        fail(error, "cannot map " + path);
+        return nullptr;
+    }
+    m->map_      = base;
+    m->mapBytes_ = size_t(st.st_size);
+    if (!m->bind(static_cast<const uint8_t*>(base), m->mapBytes_, error)) return nullptr;
+    return m;
+#else
+    std::ifstream f(path, std::ios::binary | std::ios::ate);
+    if (!f) {
+        fail(error, "cannot open " + path);
+        return nullptr;
+    }
+    std::vector<char> buf(size_t(f.tellg()));
+    f.seekg(0);
+    f.read(buf.data(), std::streamsize(buf.size()));
+    return fromBytes(buf.data(), buf.size(), error);
+#endif
+}
+
+std::unique_ptr<ChampionModel> ChampionModel::fromBytes(const void* data, size_t size,
+                                                        std::string* error) {
+    std::unique_ptr<ChampionModel> m(new ChampionModel());
+    m->owned_.resize((size + 7) / 8);
+    std::memcpy(m->owned_.data(), data, size);
+    if (!m->bind(reinterpret_cast<const uint8_t*>(m->owned_.data()), size, error)) return nullptr;
+    return m;
+}
+
+ChampionModel::~ChampionModel() {
+#ifndef _WIN32
+    if (map_) munmap(map_, mapBytes_);
+#endif
+}
+
+// Everything the player will index is checked once, here.
+bool ChampionModel::bind(const uint8_t* base, size_t size, std::string* error) {
+    if (size < sizeof(ChampionHeader)) return fail(error, "file too short");
+    const auto* h = reinterpret_cast<const ChampionHeader*>(base);
+    if (h->magic != CHAMPION_MAGIC)     return fail(error, "not a champion file");
+    if (h->version != CHAMPION_VERSION) return fail(error, "unsupported champion version");
+    if (h->fileBytes > size)            return fail(error, "file truncated");
+    if (h->mode != PUSH && h->mode != PULL) return fail(error, "unknown execution mode");
+
+    auto inside = [&](uint32_t offset, uint64_t count, size_t elem) {
+        return offset % 8 == 0 && offset + count * elem <= h->fileBytes;
+    };
+    if (!inside(h->initOffset,   h->nodes,     sizeof(float))        ||
+        !inside(h->inputOffset,  h->inputs,    sizeof(uint32_t))     ||
+        !inside(h->outputOffset, h->outputs,   sizeof(uint32_t))     ||
+        !inside(h->stepOffset,   h->steps + 1, sizeof(ChampionStep)) ||
+        !inside(h->edgeOffset,   h->edges,     sizeof(ChampionEdge)))
+        return fail(error, "array out of bounds");
+
+    header_  = h;
+    init_    = reinterpret_cast<const float*>(base + h->initOffset);
+    inputs_  = reinterpret_cast<const uint32_t*>(base + h->inputOffset);
+    outputs_ = reinterpret_cast<const uint32_t*>(base + h->outputOffset);
+    steps_   = reinterpret_cast<const ChampionStep*>(base + h->stepOffset);
+    edges_   = reinterpret_cast<const ChampionEdge*>(base + h->edgeOffset);
+
+    for (uint32_t i = 0; i < h->inputs; ++i)
+        if (inputs_[i] >= h->nodes) return fail(error, "bad input index");
+    for (uint32_t i = 0; i < h->outputs; ++i)
+        if (outputs_[i] >= h->nodes) return fail(error, "bad output index");
+    for (uint32_t s = 0; s < h->steps; ++s) {
+        const ChampionStep& st = steps_[s];
+        if (st.node >= h->nodes || st.firstEdge > steps_[s + 1].firstEdge)
+            return fail(error, "bad step");
+        if (st.activation != CHAMPION_ACT_NONE && st.activation > uint8_t(neat::Activation::LINEAR))
+            return fail(error, "unknown activation");
+    }
+    if (steps_[0].firstEdge != 0 || steps_[h->steps].firstEdge != h->edges)
+        return fail(error, "bad edge ranges");
+    for (uint32_t e = 0; e < h->edges; ++e)
+        if (edges_[e].node >= h->nodes) return fail(error, "bad edge");
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// ChampionPlayer
+// ---------------------------------------------------------------------------
+
+ChampionPlayer::ChampionPlayer(const ChampionModel& model)
+ : m_(model),
+   values_(model.header().nodes),
+   next_(model.header().nodes),
+   out_(model.header().outputs)
+{
+    reset();
+}
+
+void ChampionPlayer::reset() {
+    std::copy(m_.init_, m_.init_ + values_.size(), values_.begin());
+    std::copy(m_.init_, m_.init_ + next_.size(), next_.begin());
+}
+
+const float* ChampionPlayer::feed(const float* in) {
+    const ChampionHeader& h = *m_.header_;
+    const ChampionStep* steps = m_.steps_;
+    const ChampionEdge* edges = m_.edges_;
+    float* x = values_.data();
+
+    if (h.mode == PUSH) {
+        // the same pass as Network::feed, over flat arrays
+        std::copy(m_.init_, m_.init_ + h.nodes, x);
+        for (uint32_t i = 0; i < h.inputs; ++i) x[m_.inputs_[i]] = in[i];
+        for (uint32_t s = 0; s < h.steps; ++s) {
+            uint32_t n = steps[s].node;
+            float v = x[n];
+            for (uint32_t e = steps[s].firstEdge; e < steps[s + 1].firstEdge; ++e)
+                x[edges[e].node] += v * edges[e].weight;
+            if (steps[s].activation != CHAMPION_ACT_NONE)
+                x[n] = neat::activate(neat::Activation(steps[s].activation), x[n]);
+        }
+    } else {
+        // one synchronous tick, like RecurrentNetwork::feed
+        float* nx = next_.data();
+        for (uint32_t i = 0; i < h.inputs; ++i) x[m_.inputs_[i]] = in[i];
+        for (uint32_t s = 0; s < h.steps; ++s) {
+            float sum = 0.0f;
+            for (uint32_t e = steps[s].firstEdge; e < steps[s + 1].firstEdge; ++e)
+                sum += edges[e].weight * x[edges[e].node];
+            nx[steps[s].node] = steps[s].activation != CHAMPION_ACT_NONE
+                ? neat::activate(neat::Activation(steps[s].activation), sum) : sum;
+        }
+        for (uint32_t i = 0; i < h.inputs; ++i) nx[m_.inputs_[i]] = x[m_.inputs_[i]];
+        values_.swap(next_);
+        x = values_.data();
+    }
+
+    for (uint32_t i = 0; i < h.outputs; ++i) out_[i] = x[m_.outputs_[i]];
+    return out_.data();
+}
+
+int ChampionPlayer::decide(const float* in) {
+    const float* out = feed(in);
+    return int(std::max_element(out, out + out_.size()) - out);
+}
+
+} // namespace player
@@ -0,0 +1,79 @@
+// ChampionPlayer.h
+#pragma once
+#include "ChampionFormat.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace player {
+
+/**
+ * @brief  An exported champion, mapped read-only into memory.
+ *
+ * load() checks the header and every index once; after that the arrays
+ * are used in place. One model can back any number of ChampionPlayers
+ * (e.g. one per thread). Depends on neither raylib nor the trainer.
+ */
+class ChampionModel {
+public:
+    /// nullptr on failure; the reason goes to *error if given.
+    static std::unique_ptr<ChampionModel> load(const std::string& path,
+                                               std::string* error = nullptr);
+    /// Use a buffer that is already in memory (copied).
+    static std::unique_ptr<ChampionModel> fromBytes(const void* data, size_t size,
+                                                    std::string* error = nullptr);
+    ~ChampionModel();
+
+    const ChampionHeader& header() const { return *header_; }
+    size_t inputs()  const { return header_->inputs; }
+    size_t outputs() const { return header_->outputs; }
+    bool   recurrent() const { return header_->mode == PULL; }
+
+private:
+    friend class ChampionPlayer;
+    ChampionModel() = default;
+    ChampionModel(const ChampionModel&)            = delete;
+    ChampionModel& operator=(const ChampionModel&) = delete;
+
+    bool bind(const uint8_t* base, size_t size, std::string* error);
+
+    void*  map_      = nullptr;          // mmap'd file (POSIX)
+    size_t mapBytes_ = 0;
+    std::vector<uint64_t> owned_;        // 8-byte aligned copy otherwise
+
+    const ChampionHeader* header_  = nullptr;
+    const float*          init_    = nullptr;
+    const uint32_t*       inputs_  = nullptr;
+    const uint32_t*       outputs_ = nullptr;
+    const ChampionStep*   steps_   = nullptr;
+    const ChampionEdge*   edges_   = nullptr;
+};
+
+/**
+ * @brief  Runs a ChampionModel. decide() does not allocate; a call costs
+ *         one pass over the model's edges.
+ *
+ * Recurrent champions keep their node state between calls; reset() at the
+ * start of every episode.
+ */
+class ChampionPlayer {
+public:
+    explicit ChampionPlayer(const ChampionModel& model);
+
+    /// One forward pass (one tick); in holds model.inputs() values. The
+    /// returned model.outputs() values stay valid until the next call.
+    const float* feed(const float* in);
+
+    /// Index of the largest output (the move).
+    int decide(const float* in);
+
+    void reset();
+
+private:
+    const ChampionModel& m_;
+    std::vector<float> values_, next_;
+    std::vector<float> out_;
+};
+
+} // namespace player
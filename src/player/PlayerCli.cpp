@@ -0,0 +1,80 @@
+// PlayerCli.cpp
+//
+// Serve moves from an exported champion (SnakeNEAT --export):
+//   snake-player CHAMPION.snch              one line of inputs in, one move out
+//                                           (a line "reset" clears recurrent state)
+//   snake-player CHAMPION.snch --bench N    time N decisions on random inputs
+
+#include "ChampionPlayer.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace player;
+
+int main(int argc, char** argv) {
+    if (argc != 2 && !(argc == 4 && std::strcmp(argv[2], "--bench") == 0)) {
+        std::cerr << "usage: " << argv[0] << " CHAMPION [--bench N]\n";
+        return 2;
+    }
+    std::string error;
+    auto model = ChampionModel::load(argv[1], &error);
+    if (!model) {
+        std::cerr << argv[1] << ": " << error << "\n";
+        return 1;
+    }
+    const ChampionHeader& h = model->header();
+    std::cerr << argv[1] << ": " << h.inputs << " inputs, " << h.outputs << " outputs, "
+              << h.nodes << " nodes, " << h.edges << " edges"
+              << (model->recurrent() ? ", recurrent" : "") << "\n";
+
+    ChampionPlayer net(*model);
+    std::vector<float> in(model->inputs());
+
+    if (argc == 4) {
+        long n = std::atol(argv[3]);
+        if (n <= 0) {
+            std::cerr << "--bench needs a positive count\n";
+            return 2;
+        }
+        // pre-generate inputs so the timed loop is decisions only
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> U(-1.0f, 1.0f);
+        std::vector<float> pool(4096 * in.size());
+        for (float& v : pool) v = U(rng);
+
+        long checksum = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (long i = 0; i < n; ++i)
+            checksum += net.decide(&pool[(i & 4095) * in.size()]);
+        auto t1 = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        std::cout << n << " decisions, " << ns / double(n) << " ns/decision"
+                  << " (checksum " << checksum << ")\n";
+        return 0;
+    }
+
+    // one decision per line: whitespace-separated inputs, or "reset"
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (line == "reset") {
+            net.reset();
+            continue;
+        }
+        std::istringstream ss(line);
+        size_t k = 0;
+        while (k < in.size() && ss >> in[k]) ++k;
+        if (k == 0) continue;
+        if (k != in.size()) {
+            std::cerr << "expected " << in.size() << " inputs, got " << k << "\n";
+            return 1;
+        }
+        std::cout << net.decide(in.data()) << std::endl;
+    }
+    return 0;
+}
@@ -3,12 +3,13 @@
 #include "Renderer.h"
 #include <unordered_map>
 #include <cstdio>      // for snprintf
-#include <cmath>       // for std::fabs
+#include <cmath>       // for std::fabs, std::lround
 
 #include "game/Snake.h" 
 #include <raylib.h>
 #include <algorithm>
 #include <iostream>
+#include <string>
 using namespace render;
 using namespace game;
 using namespace neat;
@@ -21,6 +22,7 @@ Renderer::Renderer(int sw, int sh, int gw, int gh)
 }
 
 Renderer::~Renderer(){
+    if (netTex_.id != 0) UnloadRenderTexture(netTex_);
     CloseWindow();
 }
 
@@ -66,8 +68,19 @@ void Renderer::drawFood(int x, int y){
 
 void Renderer::drawNetwork(const Network& net) {
     // Get the current genome (structure) and activations (neuron outputs)
-    const auto& genome      = net.getGenome();
-    const auto& activations = net.getActivations();
+    drawNetwork(net.getGenome(), net.getActivations());
+}
+
+// Network panel geometry: right 40% of the window, node radius, and the
+// margin the pre-rendered texture keeps around the panel for the circles
+static constexpr float NODE_R     = 5.0f;
+static constexpr float TEX_MARGIN = NODE_R + 2.0f;
+
+const Renderer::NetLayout& Renderer::layoutFor(const Genome& genome, uint64_t hash) {
+    auto cached = layouts_.find(hash);
+    if (cached != layouts_.end()) return cached->second;
+    // training shows a new champion every generation; keep the cache small
+    if (layouts_.size() >= 64) layouts_.clear();
 
     // Separate all nodes into input, hidden, and output node ID lists
     std::vector<NodeId> inputs, hidden, outputs;
@@ -143,7 +156,7 @@ void Renderer::drawNetwork(const Network& net) {
         layers[totalLayers - 1].push_back(id); // Outputs in last column
 
     // 6. Assign screen coordinates for each node, spacing evenly vertically within its layer
-    std::unordered_map<NodeId, Vector2> positions;
+    NetLayout& layout = layouts_[hash];
     for (int layerIdx = 0; layerIdx < totalLayers; ++layerIdx) {
         // Compute the x position for this layer/column
         float x = areaX + areaW * (float(layerIdx) / float(totalLayers - 1));
@@ -154,10 +167,33 @@ void Renderer::drawNetwork(const Network& net) {
         for (size_t i = 0; i < count; ++i) {
             // Spread the nodes vertically, with equal spacing
             float y = areaY + areaH * (float(i + 1) / float(count + 1));
-            positions[bucket[i]] = { x, y };
+            layout.ids.push_back(bucket[i]);
+            layout.pos.push_back({ x, y });
         }
     }
 
+    return layout;
+}
+
+void Renderer::renderNetworkStatic(const NetLayout& layout, const Genome& genome) {
+    float areaW = screenW_ * 0.4f;
+    float areaH = screenH_ * 0.9f;
+    int texW = int(areaW + 2 * TEX_MARGIN) + 1;
+    int texH = int(areaH + 2 * TEX_MARGIN) + 1;
+    if (netTex_.id == 0 || netTex_.texture.width != texW || netTex_.texture.height != texH) {
+        if (netTex_.id != 0) UnloadRenderTexture(netTex_);
+        netTex_ = LoadRenderTexture(texW, texH);
+    }
+    netTexOrigin_ = { screenW_ * 0.55f - TEX_MARGIN, screenH_ * 0.05f - TEX_MARGIN };
+
+    std::unordered_map<NodeId, Vector2> positions;
+    for (size_t i = 0; i < layout.ids.size(); ++i)
+        positions[layout.ids[i]] = { layout.pos[i].x - netTexOrigin_.x,
+                                     layout.pos[i].y - netTexOrigin_.y };
+
+    BeginTextureMode(netTex_);
+    ClearBackground(BLANK);
+
     // ---- Draw all enabled connections (edges) ----
     for (const auto& kv : genome.connections) {
         const auto& cg = kv.second;
@@ -173,15 +209,53 @@ void Renderer::drawNetwork(const Network& net) {
         DrawLineV(itA->second, itB->second, LIGHTGRAY);
     }
 
-    // ---- Draw all nodes (neurons) ----
-    const float nodeR = 5.0f; // Radius of each node's circle
-    for (const auto& kv : positions) {
-        NodeId id = kv.first;      // The node's ID
-        Vector2 pos = kv.second;   // Its screen position
+    // ---- Node outlines; the fill is drawn per frame inside them ----
+    for (const auto& kv : positions)
+        DrawCircleLines(int(kv.second.x), int(kv.second.y), NODE_R, BLACK);
+
+    EndTextureMode();
+}
+
+// "%.2f" labels for activations in [-1, 1], formatted once
+static const char* activationLabel(float act, char (&buf)[32]) {
+    static const auto labels = [] {
+        std::vector<std::string> l(201);
+        char tmp[32];
+        for (int i = 0; i <= 200; ++i) {
+            snprintf(tmp, sizeof(tmp), "%.2f", (i - 100) / 100.0f);
+            l[i] = tmp;
+        }
+        return l;
+    }();
+    if (act >= -1.0f && act <= 1.0f)
+        return labels[std::lround(act * 100.0f) + 100].c_str();
+    snprintf(buf, sizeof(buf), "%.2f", act);
+    return buf;
+}
+
+void Renderer::drawNetwork(const Genome& genome,
+                           const std::unordered_map<NodeId, float>& activations) {
+    uint64_t hash = genome.structureHash();
+    const NetLayout& layout = layoutFor(genome, hash);
+
+    // static part: re-rendered only when the structure changes
+    if (!netTexValid_ || netTexHash_ != hash) {
+        renderNetworkStatic(layout, genome);
+        netTexHash_  = hash;
+        netTexValid_ = true;
+    }
+    // render textures are stored upside down
+    DrawTextureRec(netTex_.texture,
+                   { 0.0f, 0.0f, float(netTex_.texture.width), -float(netTex_.texture.height) },
+                   netTexOrigin_, WHITE);
+
+    // ---- Per frame: node fill colors and activation labels ----
+    for (size_t i = 0; i < layout.ids.size(); ++i) {
+        Vector2 pos = layout.pos[i];
 
         // Look up activation value (or 0 if not found)
         float act = 0.0f;
-        auto it = activations.find(id);
+        auto it = activations.find(layout.ids[i]);
         if (it != activations.end())
             act = it->second;
 
@@ -191,17 +265,13 @@ void Renderer::drawNetwork(const Network& net) {
             ? Color{0, inten, 0, 255}
             : Color{inten, 0, 0, 255};
 
-        // Draw filled circle
-        DrawCircleV(pos, nodeR, col);
-
-        // Draw outline
-        DrawCircleLines(int(pos.x), int(pos.y), nodeR, BLACK);
+        // Filled circle inside the pre-rendered outline
+        DrawCircleV(pos, NODE_R - 1.0f, col);
 
         // Draw the activation value as text next to the node
         char buf[32];
-        snprintf(buf, sizeof(buf), "%.2f", act);
-        DrawText(buf,
-                 int(pos.x + nodeR + 2),
+        DrawText(activationLabel(act, buf),
+                 int(pos.x + NODE_R + 2),
                  int(pos.y - 8),
                  10,
                  BLACK);
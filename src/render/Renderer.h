@@ -1,6 +1,9 @@
 // Renderer.h
 #pragma once
 #include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <raylib.h>
 #include "game/Snake.h"
 #include "neat/Network.h"
 
@@ -15,12 +18,31 @@ public:
     void drawSnake(const std::vector<game::Vec2i>& body);
     void drawFood(int x, int y);
     void drawNetwork(const neat::Network& net);
+    void drawNetwork(const neat::Genome& genome,
+                     const std::unordered_map<neat::NodeId, float>& activations);
     void drawStats(int gen, float maxF, float avgF, int speciesCount);
     void endFrame();
     bool shouldClose();
     void processUI(bool& paused, float& speed, int& observeIdx);
 private:
+    // node positions for one network structure (weights don't matter)
+    struct NetLayout {
+        std::vector<neat::NodeId> ids;
+        std::vector<Vector2>      pos;
+    };
+
+    const NetLayout& layoutFor(const neat::Genome& genome, uint64_t hash);
+    void renderNetworkStatic(const NetLayout& layout, const neat::Genome& genome);
+
     int screenW_, screenH_, gridW_, gridH_;
+
+    // layouts cached by Genome::structureHash(); edges and node outlines of
+    // the network on screen are pre-rendered into netTex_
+    std::unordered_map<uint64_t, NetLayout> layouts_;
+    RenderTexture2D netTex_{};
+    Vector2         netTexOrigin_{};
+    uint64_t        netTexHash_ = 0;
+    bool            netTexValid_ = false;
 };
 
 } // namespace render
@@ -0,0 +1,222 @@
+// Sweep.cpp
+#include "Sweep.h"
+#include "ThreadPool.h"
+#include "game/Game.h"
+#include "neat/NEAT.h"
+#include "neat/Network.h"
+#include "neat/RecurrentNetwork.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+namespace sweep {
+
+// ---------------------------------------------------------------------------
+// Sweep file
+// ---------------------------------------------------------------------------
+
+static bool applyKey(ExperimentConfig& c, const std::string& key, const std::string& text) {
+    char* end = nullptr;
+    double v = std::strtod(text.c_str(), &end);
+    if (text.empty() || *end != '\0') return false;
+    if      (key == "pop")      c.popSize  = std::max(2, int(v));
+    else if (key == "gridW")    c.gridW    = std::max(2, int(v));
+    else if (key == "gridH")    c.gridH    = std::max(2, int(v));
+    else if (key == "maxTicks") c.maxTicks = std::max(1, int(v));
+    else return c.neat.set(key, float(v));
+    return true;
+}
+
+bool parseSweepFile(const std::string& path, std::vector<ExperimentConfig>& out) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Sweep: cannot open " << path << "\n";
+        return false;
+    }
+
+    std::string line;
+    for (int lineNo = 1; std::getline(in, line); ++lineNo) {
+        line = line.substr(0, line.find('#'));
+
+        // partial configs built so far for this line; each key multiplies them
+        std::vector<ExperimentConfig> family(1);
+        std::istringstream tokens(line);
+        std::string tok;
+        bool any = false;
+        while (tokens >> tok) {
+            auto eq = tok.find('=');
+            if (eq == std::string::npos || eq == 0) {
+                std::cerr << path << ":" << lineNo << ": expected key=value, got '" << tok << "'\n";
+                return false;
+            }
+            std::string key = tok.substr(0, eq);
+            std::vector<std::string> values;
+            std::istringstream list(tok.substr(eq + 1));
+            for (std::string v; std::getline(list, v, ',');) values.push_back(v);
+            if (values.empty()) values.push_back("");
+
+            std::vector<ExperimentConfig> next;
+            for (const auto& base : family) {
+                for (const auto& v : values) {
+                    ExperimentConfig c = base;
+                    if (!applyKey(c, key, v)) {
+                        std::cerr << path << ":" << lineNo << ": bad setting " << key << "=" << v << "\n";
+                        return false;
+                    }
+                    c.name += (c.name.empty() ? "" : " ") + key + "=" + v;
+                    next.push_back(std::move(c));
+                }
+            }
+            family.swap(next);
+            any = true;
+        }
+        if (any) out.insert(out.end(), family.begin(), family.end());
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Runner
+// ---------------------------------------------------------------------------
+
+namespace {
+
+struct Experiment {
+    ExperimentResult result;
+    std::unique_ptr<neat::NEAT> neat;     // built on first step, freed when done
+    std::unique_ptr<game::Game> game;
+    double windowSum   = 0.0;             // champion fitness since the last rung
+    int    windowCount = 0;
+};
+
+// Scores reported at each rung by the runs that got there.
+class Rungs {
+public:
+    explicit Rungs(const SweepOptions& opts) : opts_(opts) {}
+
+    /// Record score at rung; true if the run should continue.
+    bool promote(int rung, double score) {
+        std::lock_guard<std::mutex> lk(mutex_);
+        auto& seen = scores_[rung];
+        seen.push_back(score);
+        if (int(seen.size()) < opts_.minPeers) return true;
+        size_t better = std::count_if(seen.begin(), seen.end(), [&](double s) { return s > score; });
+        size_t keep   = size_t(std::ceil(opts_.keepFraction * seen.size()));
+        return better < keep;
+    }
+
+private:
+    const SweepOptions& opts_;
+    std::mutex mutex_;
+    std::map<int, std::vector<double>> scores_;
+};
+
+struct SweepState {
+    const SweepOptions& opts;
+    ThreadPool pool;
+    Rungs rungs;
+    std::mutex logMutex;
+
+    explicit SweepState(const SweepOptions& o) : opts(o), pool(o.threads), rungs(o) {}
+};
+
+} // namespace
+
+// One generation of one experiment; re-submits itself until the run ends.
+static void step(Experiment& e, SweepState& st) {
+    using Clock = std::chrono::steady_clock;
+    auto t0 = Clock::now();
+    const ExperimentConfig& cfg = e.result.config;
+    if (!e.neat) {
+        e.neat = std::make_unique<neat::NEAT>(cfg.popSize, st.opts.sensors.inputs(), st.opts.outputs, cfg.neat);
+        e.game = std::make_unique<game::Game>(cfg.gridW, cfg.gridH, cfg.maxTicks, st.opts.outputs,
+                                               st.opts.sensors);
+    }
+    e.neat->expand();
+
+    double best = -1e9;
+    for (neat::Genome* g : e.neat->population()) {
+        if (cfg.neat.allowRecurrent) {
+            neat::RecurrentNetwork net(*g);
+            g->fitness = float(e.game->evaluate(net).fitness);
+        } else {
+            neat::Network net(*g);
+            g->fitness = float(e.game->evaluate(net).fitness);
+        }
+        best = std::max(best, double(g->fitness));
+    }
+    e.neat->epoch([](neat::Genome&){ /* already evaluated */ });
+
+    ExperimentResult& r = e.result;
+    r.generations++;
+    r.bestFitness = std::max(r.bestFitness, best);
+    e.windowSum += best;
+    e.windowCount++;
+    r.seconds += std::chrono::duration<double>(Clock::now() - t0).count();
+
+    bool done = r.generations >= st.opts.generations;
+    if (done || r.generations % st.opts.rungEvery == 0) {
+        r.score = e.windowSum / e.windowCount;
+        e.windowSum   = 0.0;
+        e.windowCount = 0;
+        if (!done && !st.rungs.promote(r.generations / st.opts.rungEvery, r.score))
+            r.cancelled = done = true;
+    }
+    if (done) {
+        e.neat.reset();
+        e.game.reset();
+        std::lock_guard<std::mutex> lk(st.logMutex);
+        std::cout << "[sweep] " << cfg.name << ": "
+                  << (r.cancelled ? "cancelled" : "finished") << " after " << r.generations
+                  << " gens, score " << r.score << ", best " << r.bestFitness << "\n";
+        return;
+    }
+    // waiting runs hold their population packed
+    e.neat->compact();
+    st.pool.submit([&e, &st] { step(e, st); });
+}
+
+std::vector<ExperimentResult> runSweep(const std::vector<ExperimentConfig>& configs,
+                                       const SweepOptions& opts) {
+    std::vector<Experiment> experiments(configs.size());
+    for (size_t i = 0; i < configs.size(); ++i)
+        experiments[i].result.config = configs[i];
+
+    {
+        SweepState st(opts);
+        std::cout << "[sweep] " << configs.size() << " experiment(s) on "
+                  << st.pool.size() << " thread(s)\n";
+        for (auto& e : experiments)
+            st.pool.submit([&e, &st] { step(e, st); });
+        st.pool.wait();
+    }
+
+    std::vector<ExperimentResult> results;
+    results.reserve(experiments.size());
+    for (auto& e : experiments) results.push_back(std::move(e.result));
+    // completed runs first, then by how far they got, then by score
+    std::sort(results.begin(), results.end(), [](const ExperimentResult& a, const ExperimentResult& b) {
+        if (a.generations != b.generations) return a.generations > b.generations;
+        return a.score > b.score;
+    });
+    return results;
+}
+
+bool writeSweepCsv(const std::string& path, const std::vector<ExperimentResult>& results) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "config,generations,score,best_fitness,cancelled,seconds\n";
+    for (const auto& r : results)
+        out << '"' << r.config.name << "\"," << r.generations << ',' << r.score << ','
+            << r.bestFitness << ',' << (r.cancelled ? 1 : 0) << ',' << r.seconds << '\n';
+    return bool(out);
+}
+
+} // namespace sweep
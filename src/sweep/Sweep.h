@@ -0,0 +1,62 @@
+// Sweep.h
+#pragma once
+#include "neat/NeatConfig.h"
+#include "game/Sensors.h"
+#include <string>
+#include <vector>
+
+namespace sweep {
+
+/// One training run: NEAT knobs plus the population / game settings.
+struct ExperimentConfig {
+    std::string      name;        // "key=value ..." as given in the sweep file
+    neat::NeatParams neat;
+    int popSize  = 100;
+    int gridW    = 8;
+    int gridH    = 8;
+    int maxTicks = 1000;
+};
+
+struct ExperimentResult {
+    ExperimentConfig config;
+    int    generations = 0;     // completed
+    double bestFitness = 0.0;   // best single evaluation seen
+    double score       = 0.0;   // mean champion fitness over the last rung
+    bool   cancelled   = false;
+    double seconds     = 0.0;   // time spent running its generations
+};
+
+struct SweepOptions {
+    int      generations  = 200;
+    unsigned threads      = 0;      // 0: one per hardware thread
+    game::SensorConfig sensors;     // network inputs follow from it
+    int      outputs      = 4;
+    // early cancellation (asynchronous successive halving): every rungEvery
+    // generations a run is compared with the runs that already reached the
+    // same rung and stopped unless it ranks in the top keepFraction of them
+    int      rungEvery    = 25;
+    double   keepFraction = 0.5;
+    int      minPeers     = 4;      // never cancel before this many peers reported
+};
+
+/**
+ * Parse a sweep description. One experiment family per line, blank lines
+ * and '#' comments ignored:
+ *
+ *     probAddNode=0.003,0.006,0.012  c3=0.4,0.8  pop=150
+ *
+ * Comma-separated values expand to the cartesian product. Keys are the
+ * NeatParams field names plus pop, gridW, gridH and maxTicks. Returns false
+ * (with a message on stderr) on a syntax error or unknown key.
+ */
+bool parseSweepFile(const std::string& path, std::vector<ExperimentConfig>& out);
+
+/// Run every experiment concurrently on one shared pool. Results come back
+/// best first: runs that got further rank above cancelled ones, then by score.
+std::vector<ExperimentResult> runSweep(const std::vector<ExperimentConfig>& configs,
+                                       const SweepOptions& opts);
+
+/// Write results as CSV (one row per experiment).
+bool writeSweepCsv(const std::string& path, const std::vector<ExperimentResult>& results);
+
+} // namespace sweep
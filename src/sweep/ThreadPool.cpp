@@ -0,0 +1,98 @@
+// ThreadPool.cpp
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace sweep {
+
+// worker index of the calling thread in the pool that runs it
+static thread_local const ThreadPool* tlsPool  = nullptr;
+static thread_local unsigned          tlsIndex = 0;
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < threads; ++i)
+        queues_.push_back(std::make_unique<Queue>());
+    for (unsigned i = 0; i < threads; ++i)
+        workers_.emplace_back(&ThreadPool::run, this, i);   // queues_ is final by now
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        stop_ = true;
+    }
+    workCv_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+void ThreadPool::submit(Task task) {
+    // own deque when called from a worker, otherwise spread round-robin
+    unsigned q = tlsPool == this ? tlsIndex
+                                 : nextQueue_.fetch_add(1, std::memory_order_relaxed) % size();
+    // count the task before anyone can steal it, or a thief could finish
+    // it and let pending_ reach 0 (or wrap) while other work still runs
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        queued_++;
+        pending_++;
+    }
+    {
+        std::lock_guard<std::mutex> lk(queues_[q]->mutex);
+        queues_[q]->tasks.push_back(std::move(task));
+    }
+    workCv_.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lk(mutex_);
+    doneCv_.wait(lk, [&] { return pending_ == 0; });
+}
+
+bool ThreadPool::take(unsigned self, Task& out) {
+    {
+        Queue& own = *queues_[self];
+        std::lock_guard<std::mutex> lk(own.mutex);
+        if (!own.tasks.empty()) {
+            out = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+    for (unsigned k = 1; k < size(); ++k) {
+        Queue& victim = *queues_[(self + k) % size()];
+        std::lock_guard<std::mutex> lk(victim.mutex);
+        if (!victim.tasks.empty()) {
+            out = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(unsigned self) {
+    tlsPool  = this;
+    tlsIndex = self;
+    for (;;) {
+        Task task;
+        if (take(self, task)) {
+            {
+                std::lock_guard<std::mutex> lk(mutex_);
+                queued_--;
+            }
+            task();
+            std::lock_guard<std::mutex> lk(mutex_);
+            if (--pending_ == 0) doneCv_.notify_all();
+            continue;
+        }
+        // queued_ can be briefly ahead of the deques (a submit between
+        // counting and pushing) or stale while another worker steals; then
+        // the next take() simply comes back empty and we try again
+        std::unique_lock<std::mutex> lk(mutex_);
+        workCv_.wait(lk, [&] { return stop_ || queued_ > 0; });
+        if (stop_ && queued_ == 0) return;
+    }
+}
+
+} // namespace sweep
@@ -0,0 +1,60 @@
+// ThreadPool.h
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sweep {
+
+/**
+ * @brief  Work-stealing thread pool.
+ *
+ * Every worker owns a deque. It takes work from the front of its own deque
+ * and, when that is empty, steals from the back of the others. Tasks
+ * submitted from inside a task go to the back of the submitting worker's
+ * deque, so a task that re-submits itself (one step of a long job) waits
+ * behind the worker's other jobs: long jobs advance round-robin.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = 0);   // 0: one per hardware thread
+    ~ThreadPool();                               // finishes queued work first
+
+    void submit(std::function<void()> task);
+
+    /// Block until every submitted task (including ones they submit) is done.
+    void wait();
+
+    unsigned size() const { return unsigned(queues_.size()); }
+
+private:
+    using Task = std::function<void()>;
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void run(unsigned self);
+    bool take(unsigned self, Task& out);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;                 // guards queued_, pending_, stop_
+    std::condition_variable workCv_;   // queued_ > 0 or stop_
+    std::condition_variable doneCv_;   // pending_ == 0
+    size_t queued_  = 0;               // tasks sitting in some deque
+    size_t pending_ = 0;               // submitted and not yet finished
+    bool   stop_    = false;
+    std::atomic<unsigned> nextQueue_{0};
+};
+
+} // namespace sweep
@@ -0,0 +1,357 @@
+// Genealogy.cpp
+#include "Genealogy.h"
+#include "LogFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace telemetry {
+
+static constexpr char     LOG_MAGIC[4]   = { 'S', 'N', 'G', 'L' };
+static constexpr char     BLOCK_MAGIC[4] = { 'S', 'N', 'G', 'B' };
+static constexpr uint16_t LOG_VERSION    = 1;
+static constexpr int      FLUSH_MS       = 2000;   // write a partial block after this long
+
+struct LogHeader {
+    char     magic[4];
+    uint16_t version;
+    uint16_t reserved0;
+    uint64_t reserved1;
+};
+static_assert(sizeof(LogHeader) == 16, "log header is 16 bytes");
+
+struct BlockHeader {
+    char     magic[4];
+    uint32_t run;
+    uint32_t count;
+    uint32_t bytes;          // encoded records that follow
+    uint64_t minId, maxId;
+};
+static_assert(sizeof(BlockHeader) == 32, "block header is 32 bytes");
+
+// PATH.idx: one entry per block, in file order
+struct IndexEntry {
+    uint64_t offset;         // of the BlockHeader
+    uint64_t minId, maxId;
+    uint32_t run, count;
+    uint32_t bytes;
+    uint32_t reserved;
+};
+static_assert(sizeof(IndexEntry) == 40, "index entry is 40 bytes");
+
+// ---------------------------------------------------------------------------
+// Block coding. Records are sorted by ID; each is stored as the ID delta,
+// its parents as distances back from its ID (they are always older),
+// generation and species as zigzag changes from the previous record, then
+// fitness and origin verbatim: typically 11-13 bytes instead of 40.
+// ---------------------------------------------------------------------------
+
+static void putVarint(std::vector<uint8_t>& b, uint64_t v) {
+    while (v >= 0x80) {
+        b.push_back(uint8_t(v) | 0x80);
+        v >>= 7;
+    }
+    b.push_back(uint8_t(v));
+}
+
+static bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t c = *p++;
+        v |= uint64_t(c & 0x7f) << shift;
+        if (!(c & 0x80)) return true;
+    }
+    return false;
+}
+
+static uint64_t zigzag(int64_t v)   { return (uint64_t(v) << 1) ^ uint64_t(v >> 63); }
+static int64_t  unzigzag(uint64_t v) { return int64_t(v >> 1) ^ -int64_t(v & 1); }
+
+static void encodeBlock(const std::vector<GenealogyRecord>& rs, std::vector<uint8_t>& out) {
+    out.clear();
+    uint64_t prevId = rs.empty() ? 0 : rs.front().id;
+    int64_t  prevGen = 0, prevSpecies = 0;
+    for (const GenealogyRecord& r : rs) {
+        putVarint(out, r.id - prevId);
+        for (uint64_t p : r.parents)
+            putVarint(out, p == 0 ? 0 : zigzag(int64_t(r.id - p)) + 1);
+        putVarint(out, zigzag(int64_t(r.generation) - prevGen));
+        putVarint(out, zigzag(int64_t(r.species) - prevSpecies));
+        uint8_t tail[5];
+        std::memcpy(tail, &r.fitness, 4);
+        tail[4] = r.origin;
+        out.insert(out.end(), tail, tail + 5);
+        prevId      = r.id;
+        prevGen     = r.generation;
+        prevSpecies = r.species;
+    }
+}
+
+static bool decodeBlock(const uint8_t* p, size_t bytes, uint32_t count, uint64_t firstId,
+                        std::vector<GenealogyRecord>& out) {
+    const uint8_t* end = p + bytes;
+    out.resize(count);
+    uint64_t prevId = firstId;
+    int64_t  prevGen = 0, prevSpecies = 0;
+    for (GenealogyRecord& r : out) {
+        uint64_t v;
+        r = GenealogyRecord{};
+        if (!getVarint(p, end, v)) return false;
+        r.id = prevId + v;
+        for (uint64_t& parent : r.parents) {
+            if (!getVarint(p, end, v)) return false;
+            parent = v == 0 ? 0 : r.id - uint64_t(unzigzag(v - 1));
+        }
+        if (!getVarint(p, end, v)) return false;
+        r.generation = int32_t(prevGen + unzigzag(v));
+        if (!getVarint(p, end, v)) return false;
+        r.species = uint32_t(prevSpecies + unzigzag(v));
+        if (end - p < 5) return false;
+        std::memcpy(&r.fitness, p, 4);
+        r.origin = p[4];
+        p += 5;
+        prevId      = r.id;
+        prevGen     = r.generation;
+        prevSpecies = r.species;
+    }
+    return p == end;
+}
+
+// The blocks of an open log: the index entries that fit the file, then
+// whatever the index is missing (e.g. after a crash), from block headers.
+// A truncated trailing block is ignored.
+static std::vector<IndexEntry> listBlocks(std::FILE* log, uint64_t logBytes, const std::string& idxPath) {
+    std::vector<IndexEntry> blocks;
+    uint64_t next = sizeof(LogHeader);
+    if (std::FILE* idx = std::fopen(idxPath.c_str(), "rb")) {
+        IndexEntry e;
+        while (std::fread(&e, sizeof(e), 1, idx) == 1) {
+            if (e.offset < next || e.offset + sizeof(BlockHeader) + e.bytes > logBytes) break;
+            blocks.push_back(e);
+            next = e.offset + sizeof(BlockHeader) + e.bytes;
+        }
+        std::fclose(idx);
+    }
+    BlockHeader h;
+    while (next + sizeof(h) <= logBytes) {
+        if (std::fseek(log, long(next), SEEK_SET) != 0 || std::fread(&h, sizeof(h), 1, log) != 1) break;
+        if (std::memcmp(h.magic, BLOCK_MAGIC, 4) != 0) break;
+        if (next + sizeof(h) + h.bytes > logBytes) break;
+        blocks.push_back({ next, h.minId, h.maxId, h.run, h.count, h.bytes, 0 });
+        next += sizeof(h) + h.bytes;
+    }
+    return blocks;
+}
+
+// ---------------------------------------------------------------------------
+// GenealogyWriter
+// ---------------------------------------------------------------------------
+
+std::unique_ptr<GenealogyWriter> GenealogyWriter::open(const std::string& path, size_t capacity) {
+    std::FILE* f = std::fopen(path.c_str(), "ab+");
+    if (!f) {
+        std::cerr << "Genealogy: cannot open " << path << ": " << std::strerror(errno) << "\n";
+        return nullptr;
+    }
+
+    // new file: write the header; existing one: must be a log of this version
+    uint64_t size = fileSize(f);
+    if (size == 0) {
+        LogHeader h{};
+        std::memcpy(h.magic, LOG_MAGIC, 4);
+        h.version = LOG_VERSION;
+        if (std::fwrite(&h, sizeof(h), 1, f) != 1 || std::fflush(f) != 0) {
+            std::fclose(f);
+            return nullptr;
+        }
+        size = sizeof(h);
+    } else {
+        LogHeader h{};
+        std::fseek(f, 0, SEEK_SET);
+        if (std::fread(&h, sizeof(h), 1, f) != 1 || std::memcmp(h.magic, LOG_MAGIC, 4) != 0 ||
+            h.version != LOG_VERSION) {
+            std::cerr << "Genealogy: " << path << " is not a log of this version, not appending\n";
+            std::fclose(f);
+            return nullptr;
+        }
+    }
+
+    // next run number; rewrite the index if it was missing blocks
+    std::string idxPath = path + ".idx";
+    std::vector<IndexEntry> blocks = listBlocks(f, size, idxPath);
+    std::FILE* idx = std::fopen(idxPath.c_str(), "wb");
+    if (!idx || (!blocks.empty() &&
+                 std::fwrite(blocks.data(), sizeof(IndexEntry), blocks.size(), idx) != blocks.size())) {
+        std::cerr << "Genealogy: cannot write " << idxPath << "\n";
+        if (idx) std::fclose(idx);
+        std::fclose(f);
+        return nullptr;
+    }
+    std::fflush(idx);
+    std::fseek(f, 0, SEEK_END);
+
+    std::unique_ptr<GenealogyWriter> w(new GenealogyWriter(capacity));
+    w->file_   = f;
+    w->index_  = idx;
+    w->offset_ = size;
+    for (const IndexEntry& e : blocks) w->run_ = std::max(w->run_, e.run + 1);
+    w->block_.reserve(BLOCK_RECORDS);
+    GenealogyWriter* self = w.get();
+    w->writer_.start([self](bool stopping) { return self->step(stopping); });
+    return w;
+}
+
+GenealogyWriter::~GenealogyWriter() {
+    writer_.stop();
+    if (file_)  std::fclose(file_);
+    if (index_) std::fclose(index_);
+    if (dropped() > 0)
+        std::cerr << "Genealogy: " << dropped() << " record(s) dropped, writer fell behind or could not write\n";
+}
+
+bool GenealogyWriter::step(bool stopping) {
+    using Clock = std::chrono::steady_clock;
+    if (block_.empty()) blockStart_ = Clock::now();
+    ring_.drain([this](const GenealogyRecord& r) { block_.push_back(r); },
+                BLOCK_RECORDS - block_.size());
+
+    bool drained = ring_.empty();
+    bool stale   = Clock::now() - blockStart_ > std::chrono::milliseconds(FLUSH_MS);
+    if (block_.size() == BLOCK_RECORDS || (!block_.empty() && drained && (stopping || stale))) {
+        if (!writeBlock(block_)) {
+            // keep the block and retry; at shutdown there is no one to wait for
+            if (stopping) {
+                ring_.dropTaken(block_.size());
+                block_.clear();
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(FLUSH_MS));
+            }
+        }
+    }
+    return drained;
+}
+
+bool GenealogyWriter::writeBlock(std::vector<GenealogyRecord>& records) {
+    std::sort(records.begin(), records.end(),
+              [](const GenealogyRecord& a, const GenealogyRecord& b) { return a.id < b.id; });
+    encodeBlock(records, encoded_);
+
+    BlockHeader h{};
+    std::memcpy(h.magic, BLOCK_MAGIC, 4);
+    h.run   = run_;
+    h.count = uint32_t(records.size());
+    h.bytes = uint32_t(encoded_.size());
+    h.minId = records.front().id;
+    h.maxId = records.back().id;
+    IndexEntry e{ offset_, h.minId, h.maxId, h.run, h.count, h.bytes, 0 };
+
+    if (std::fwrite(&h, sizeof(h), 1, file_) != 1 ||
+        std::fwrite(encoded_.data(), 1, encoded_.size(), file_) != encoded_.size() ||
+        std::fflush(file_) != 0) {
+        if (!writeFailing_) std::cerr << "Genealogy: write failed: " << std::strerror(errno) << "\n";
+        writeFailing_ = true;
+        // cut off what got out of the block, so the retry lands at offset_;
+        // if that fails too, the next block goes wherever the file ends
+        std::clearerr(file_);
+        if (!truncateTo(file_, offset_)) offset_ = fileSize(file_);
+        return false;
+    }
+    if (writeFailing_) std::cerr << "Genealogy: writing again\n";
+    writeFailing_ = false;
+    offset_ += sizeof(h) + h.bytes;
+    records.clear();
+    // the index only ever points at blocks that are fully written
+    std::fwrite(&e, sizeof(e), 1, index_);
+    std::fflush(index_);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// GenealogyReader
+// ---------------------------------------------------------------------------
+
+std::unique_ptr<GenealogyReader> GenealogyReader::open(const std::string& path) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return nullptr;
+    LogHeader h{};
+    if (std::fread(&h, sizeof(h), 1, f) != 1 || std::memcmp(h.magic, LOG_MAGIC, 4) != 0 ||
+        h.version != LOG_VERSION) {
+        std::fclose(f);
+        return nullptr;
+    }
+    std::unique_ptr<GenealogyReader> r(new GenealogyReader());
+    r->file_      = f;
+    r->fileBytes_ = fileSize(f);
+    for (const IndexEntry& e : listBlocks(f, r->fileBytes_, path + ".idx")) {
+        r->blocks_.push_back({ e.offset, e.minId, e.maxId, e.run, e.count });
+        r->lastRun_ = std::max(r->lastRun_, e.run);
+    }
+    return r;
+}
+
+GenealogyReader::~GenealogyReader() {
+    if (file_) std::fclose(file_);
+}
+
+uint64_t GenealogyReader::records() const {
+    uint64_t n = 0;
+    for (const Block& b : blocks_) n += b.count;
+    return n;
+}
+
+const std::vector<GenealogyRecord>* GenealogyReader::load(size_t block) {
+    if (cached_ == block) return &records_;
+    const Block& b = blocks_[block];
+    BlockHeader h;
+    if (std::fseek(file_, long(b.offset), SEEK_SET) != 0 || std::fread(&h, sizeof(h), 1, file_) != 1 ||
+        std::memcmp(h.magic, BLOCK_MAGIC, 4) != 0 || h.run != b.run || h.count != b.count)
+        return nullptr;
+    buf_.resize(h.bytes);
+    if (std::fread(buf_.data(), 1, h.bytes, file_) != h.bytes ||
+        !decodeBlock(buf_.data(), h.bytes, h.count, h.minId, records_)) {
+        cached_ = SIZE_MAX;
+        return nullptr;
+    }
+    cached_ = block;
+    return &records_;
+}
+
+bool GenealogyReader::find(uint32_t run, uint64_t id, GenealogyRecord& out) {
+    for (size_t i = 0; i < blocks_.size(); ++i) {
+        const Block& b = blocks_[i];
+        if (b.run != run || id < b.minId || id > b.maxId) continue;
+        const auto* rs = load(i);
+        if (!rs) continue;
+        auto it = std::lower_bound(rs->begin(), rs->end(), id,
+                                   [](const GenealogyRecord& r, uint64_t v) { return r.id < v; });
+        if (it != rs->end() && it->id == id) {
+            out = *it;
+            return true;
+        }
+    }
+    return false;
+}
+
+void GenealogyReader::forEach(uint32_t run, const std::function<void(const GenealogyRecord&)>& fn) {
+    for (size_t i = 0; i < blocks_.size(); ++i) {
+        if (blocks_[i].run != run) continue;
+        if (const auto* rs = load(i))
+            for (const GenealogyRecord& r : *rs) fn(r);
+    }
+}
+
+std::vector<GenealogyRecord> GenealogyReader::lineage(uint32_t run, uint64_t id) {
+    std::vector<GenealogyRecord> chain;
+    GenealogyRecord r;
+    while (id != 0 && find(run, id, r)) {
+        chain.push_back(r);
+        if (r.parents[0] >= id) break;   // IDs only grow; anything else is corrupt
+        id = r.parents[0];
+    }
+    return chain;
+}
+
+} // namespace telemetry
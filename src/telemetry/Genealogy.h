@@ -0,0 +1,121 @@
+// Genealogy.h
+#pragma once
+#include "LogRing.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace telemetry {
+
+/// One row per evaluated genome (see neat::Lineage).
+struct GenealogyRecord {
+    uint64_t id;
+    uint64_t parents[2];     // 0 = none
+    int32_t  generation;
+    uint32_t species;        // neat::Species::id
+    float    fitness;
+    uint8_t  origin;         // neat::Lineage::Origin bits
+    uint8_t  reserved[3];
+};
+static_assert(std::is_trivially_copyable<GenealogyRecord>::value, "copied raw");
+
+/**
+ * @brief  Append-only, block-compressed genealogy log, written off the
+ *         training thread.
+ *
+ * push() queues a record on an SpscRing (LogRing.h) and never blocks. The
+ * background thread collects records into blocks of up to BLOCK_RECORDS,
+ * sorts each by ID and stores it delta/varint coded (about a quarter of
+ * the raw size), flushing a partial block when training goes quiet.
+ *
+ * Every block is tagged with a run number, one higher than the last run
+ * in the file, so reopening a log appends a new run. Each block written
+ * is also appended to PATH.idx (offset and ID range); readers rebuild
+ * missing index entries from the block headers.
+ */
+class GenealogyWriter {
+public:
+    static constexpr size_t BLOCK_RECORDS = 4096;
+
+    /// Open (or append a run to) path. Returns nullptr on failure.
+    static std::unique_ptr<GenealogyWriter> open(const std::string& path,
+                                                 size_t capacity = 1 << 16);
+    ~GenealogyWriter();   // writes what is queued, then closes the files
+
+    // Producer side; call from one thread only. False if the record was dropped.
+    bool push(const GenealogyRecord& r) { return ring_.push(r); }
+
+    uint32_t runId() const { return run_; }
+    uint64_t dropped() const { return ring_.dropped(); }
+
+private:
+    explicit GenealogyWriter(size_t capacity) : ring_(capacity) {}
+    GenealogyWriter(const GenealogyWriter&)            = delete;
+    GenealogyWriter& operator=(const GenealogyWriter&) = delete;
+
+    // writer thread: gather a block, write it when full or stale
+    bool step(bool stopping);
+    // false (records kept, file as before) if the block could not be written
+    bool writeBlock(std::vector<GenealogyRecord>& records);
+
+    std::FILE* file_  = nullptr;
+    std::FILE* index_ = nullptr;
+    uint64_t offset_ = 0;            // where the next block goes
+    bool writeFailing_ = false;      // last block failed; reported once
+    uint32_t run_ = 1;
+    std::vector<uint8_t> encoded_;
+    std::vector<GenealogyRecord> block_;            // writer thread only
+    std::chrono::steady_clock::time_point blockStart_;
+    SpscRing<GenealogyRecord> ring_;
+    WriterThread writer_;
+};
+
+/// Random access to a genealogy log through its block index.
+class GenealogyReader {
+public:
+    /// Returns nullptr if path is missing or not a genealogy log.
+    static std::unique_ptr<GenealogyReader> open(const std::string& path);
+    ~GenealogyReader();
+
+    uint32_t lastRun() const { return lastRun_; }
+    size_t   blocks()  const { return blocks_.size(); }
+    uint64_t records() const;
+    uint64_t fileBytes() const { return fileBytes_; }
+
+    /// The record of genome id in run; false if it was never logged.
+    bool find(uint32_t run, uint64_t id, GenealogyRecord& out);
+
+    /// Every record of run, in ID order within each block.
+    void forEach(uint32_t run, const std::function<void(const GenealogyRecord&)>& fn);
+
+    /// id, then its fitter parent, grandparent, ... back to the first
+    /// ancestor that was logged.
+    std::vector<GenealogyRecord> lineage(uint32_t run, uint64_t id);
+
+private:
+    struct Block {
+        uint64_t offset, minId, maxId;
+        uint32_t run, count;
+    };
+
+    GenealogyReader() = default;
+    GenealogyReader(const GenealogyReader&)            = delete;
+    GenealogyReader& operator=(const GenealogyReader&) = delete;
+
+    const std::vector<GenealogyRecord>* load(size_t block);
+
+    std::FILE* file_ = nullptr;
+    uint64_t fileBytes_ = 0;
+    uint32_t lastRun_ = 0;
+    std::vector<Block> blocks_;
+    size_t cached_ = SIZE_MAX;                 // block held in records_
+    std::vector<GenealogyRecord> records_;
+    std::vector<uint8_t> buf_;
+};
+
+} // namespace telemetry
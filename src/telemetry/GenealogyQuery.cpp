@@ -0,0 +1,74 @@
+// GenealogyQuery.cpp
+//
+// Trace a genome's ancestry through a SnakeNEAT genealogy log:
+//   snake-lineage RUN.sngl [ID] [--run N]
+// Without ID, the fittest genome of the run; without --run, the last run.
+
+#include "Genealogy.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using namespace telemetry;
+
+// see neat::Lineage::Origin
+static std::string originName(uint8_t origin) {
+    static const char* names[] = { "clone", "crossover", "weights", "add-connection", "add-node", "migrant" };
+    std::string s;
+    for (int b = 0; b < 6; ++b)
+        if (origin & (1u << b)) s += (s.empty() ? "" : "+") + std::string(names[b]);
+    return s.empty() ? "initial" : s;
+}
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    uint64_t id = 0;
+    long run = -1;
+    bool usage = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--run") == 0 && i + 1 < argc) run = std::atol(argv[++i]);
+        else if (!path)                                          path = argv[i];
+        else if (!id)                                            id = std::strtoull(argv[i], nullptr, 10);
+        else                                                     usage = true;
+    }
+    if (!path || usage) {
+        std::cerr << "usage: " << argv[0] << " LOG [ID] [--run N]\n";
+        return 2;
+    }
+
+    auto log = GenealogyReader::open(path);
+    if (!log) {
+        std::cerr << path << ": not a genealogy log\n";
+        return 1;
+    }
+    uint32_t r = run < 0 ? log->lastRun() : uint32_t(run);
+    std::cerr << path << ": " << log->records() << " records in " << log->blocks() << " blocks, "
+              << (log->records() ? double(log->fileBytes()) / double(log->records()) : 0.0)
+              << " bytes/record\n";
+
+    if (!id) {
+        float best = 0.0f;
+        log->forEach(r, [&](const GenealogyRecord& g) {
+            if (!id || g.fitness > best) { id = g.id; best = g.fitness; }
+        });
+        if (!id) {
+            std::cerr << "run " << r << " is empty\n";
+            return 1;
+        }
+    }
+
+    auto chain = log->lineage(r, id);
+    if (chain.empty()) {
+        std::cerr << "genome " << id << " is not in run " << r << "\n";
+        return 1;
+    }
+    std::cout << "generation,id,species,fitness,origin,other_parent\n";
+    for (const GenealogyRecord& g : chain) {
+        std::cout << g.generation << ',' << g.id << ',' << g.species << ',' << g.fitness << ','
+                  << originName(g.origin) << ',';
+        if (g.parents[1]) std::cout << g.parents[1];
+        std::cout << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,208 @@
+// LiveMonitor.cpp
+#include "LiveMonitor.h"
+#include "Sampler.h"
+#include "neat/GenomeIO.h"
+#include "neat/NEAT.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace telemetry {
+
+static constexpr uint32_t LIVE_MAGIC   = 0x4556494c; // "LIVE"
+static constexpr uint32_t LIVE_VERSION = 2;
+
+// Everything behind the seqlock
+struct LivePayload {
+    uint32_t published;        // generations so far; history[g % HISTORY]
+    uint32_t speciesCount;
+    uint32_t championBytes;
+    GenerationRecord history[LivePublisher::HISTORY];
+    SpeciesRecord    species[LivePublisher::MAX_SPECIES];
+    uint8_t          champion[LivePublisher::CHAMPION_BYTES];
+};
+
+// Shared layout. Only lock-free atomics live in shared memory.
+struct LiveLayout {
+    std::atomic<uint32_t> magic;       // written last by the publisher
+    uint32_t version;
+    uint32_t genBytes, speciesBytes;   // record sizes, so viewers can refuse
+    LiveSetup setup;                   //   a trainer built differently
+    std::atomic<uint64_t> seq;         // odd while the trainer writes
+    LivePayload payload;
+};
+
+static_assert(std::is_trivially_copyable<LivePayload>::value, "copied raw");
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "live monitor needs lock-free 64-bit atomics");
+
+static std::string shmName(const std::string& name) {
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+// ---------------------------------------------------------------------------
+// LivePublisher
+// ---------------------------------------------------------------------------
+
+std::unique_ptr<LivePublisher> LivePublisher::create(const std::string& name,
+                                                     const LiveSetup& setup) {
+    std::unique_ptr<LivePublisher> pub(new LivePublisher());
+    pub->name_ = shmName(name);
+
+    // a segment left behind by a crashed run is replaced, not reused:
+    // viewers still attached to it notice through LiveReader::replaced()
+    shm_unlink(pub->name_.c_str());
+    int fd = shm_open(pub->name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        std::cerr << "LivePublisher: shm_open(" << pub->name_ << ") failed: "
+                  << std::strerror(errno) << "\n";
+        return nullptr;
+    }
+    pub->fd_ = fd;
+    if (ftruncate(fd, off_t(sizeof(LiveLayout))) != 0) {
+        std::cerr << "LivePublisher: ftruncate failed: " << std::strerror(errno) << "\n";
+        return nullptr;
+    }
+    void* base = mmap(nullptr, sizeof(LiveLayout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        std::cerr << "LivePublisher: mmap failed: " << std::strerror(errno) << "\n";
+        return nullptr;
+    }
+    // fresh segments are zero-filled: seq 0, nothing published
+    pub->map_ = static_cast<LiveLayout*>(base);
+    LiveLayout& m = *pub->map_;
+    m.version      = LIVE_VERSION;
+    m.genBytes     = sizeof(GenerationRecord);
+    m.speciesBytes = sizeof(SpeciesRecord);
+    m.setup        = setup;
+    m.magic.store(LIVE_MAGIC, std::memory_order_release);
+    return pub;
+}
+
+LivePublisher::~LivePublisher() {
+    if (map_) munmap(map_, sizeof(LiveLayout));
+    if (fd_ >= 0) {
+        close(fd_);
+        shm_unlink(name_.c_str());
+    }
+}
+
+bool LivePublisher::publish(const GenerationRecord& stats, const neat::NEAT& neat,
+                            const neat::Genome& champion) {
+    // encode and sample first: the write window stays a few memcpys long
+    bool fits = neat::encodeGenome(champion, buf_) && buf_.size() <= CHAMPION_BYTES;
+    std::vector<SpeciesRecord> species = sampleSpecies(neat);
+    uint32_t speciesCount = uint32_t(std::min<size_t>(species.size(), MAX_SPECIES));
+
+    LivePayload& p = map_->payload;
+    uint64_t s = map_->seq.load(std::memory_order_relaxed);
+    map_->seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    p.history[p.published % HISTORY] = stats;
+    p.published++;
+    std::copy(species.begin(), species.begin() + speciesCount, p.species);
+    p.speciesCount = speciesCount;
+    if (fits) {
+        std::memcpy(p.champion, buf_.data(), buf_.size());
+        p.championBytes = uint32_t(buf_.size());
+    }
+
+    map_->seq.store(s + 2, std::memory_order_release);
+    return fits;
+}
+
+// ---------------------------------------------------------------------------
+// LiveReader
+// ---------------------------------------------------------------------------
+
+std::unique_ptr<LiveReader> LiveReader::attach(const std::string& name) {
+    std::string path = shmName(name);
+    int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) return nullptr;
+
+    std::unique_ptr<LiveReader> reader(new LiveReader());
+    reader->name_ = path;
+    reader->fd_   = fd;
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size < off_t(sizeof(LiveLayout)))
+        return nullptr;                       // still being sized
+    reader->inode_ = uint64_t(st.st_ino);
+
+    void* base = mmap(nullptr, sizeof(LiveLayout), PROT_READ, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        std::cerr << "LiveReader: mmap failed: " << std::strerror(errno) << "\n";
+        return nullptr;
+    }
+    reader->map_ = static_cast<const LiveLayout*>(base);
+    const LiveLayout& m = *reader->map_;
+    if (m.magic.load(std::memory_order_acquire) != LIVE_MAGIC)
+        return nullptr;                       // not initialized yet
+    if (m.version != LIVE_VERSION || m.genBytes != sizeof(GenerationRecord) ||
+        m.speciesBytes != sizeof(SpeciesRecord)) {
+        std::cerr << "LiveReader: " << path << " has an incompatible layout\n";
+        return nullptr;
+    }
+    reader->scratch_.resize(sizeof(LivePayload));
+    return reader;
+}
+
+LiveReader::~LiveReader() {
+    if (map_) munmap(const_cast<LiveLayout*>(map_), sizeof(LiveLayout));
+    if (fd_ >= 0) close(fd_);
+}
+
+bool LiveReader::read(LiveSnapshot& out) {
+    uint64_t before = map_->seq.load(std::memory_order_acquire);
+    if (before == lastSeq_ || (before & 1)) return false;
+
+    // copy only the used parts; the counts are re-checked after the copy
+    const LivePayload& p = map_->payload;
+    auto* copy = reinterpret_cast<LivePayload*>(scratch_.data());
+    copy->published     = p.published;
+    copy->speciesCount  = std::min(p.speciesCount, LivePublisher::MAX_SPECIES);
+    copy->championBytes = std::min(p.championBytes, LivePublisher::CHAMPION_BYTES);
+    std::memcpy(copy->history, p.history, sizeof(p.history));
+    std::memcpy(copy->species, p.species, copy->speciesCount * sizeof(SpeciesRecord));
+    std::memcpy(copy->champion, p.champion, copy->championBytes);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (map_->seq.load(std::memory_order_relaxed) != before) return false;   // torn read
+    lastSeq_ = before;
+
+    out.sequence = before;
+    uint32_t n = std::min(copy->published, LivePublisher::HISTORY);
+    out.history.clear();
+    for (uint32_t g = copy->published - n; g < copy->published; ++g)
+        out.history.push_back(copy->history[g % LivePublisher::HISTORY]);
+    out.species.assign(copy->species, copy->species + copy->speciesCount);
+
+    neat::Genome champion;
+    if (copy->championBytes > 0 &&
+        neat::decodeGenome(copy->champion, copy->championBytes, champion)) {
+        out.champion    = std::move(champion);
+        out.hasChampion = true;
+    }
+    return true;
+}
+
+const LiveSetup& LiveReader::setup() const {
+    return map_->setup;
+}
+
+bool LiveReader::replaced() const {
+    int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;                 // trainer gone; keep the last state
+    struct stat st{};
+    bool other = fstat(fd, &st) == 0 && uint64_t(st.st_ino) != inode_;
+    close(fd);
+    return other;
+}
+
+} // namespace telemetry
@@ -0,0 +1,108 @@
+// LiveMonitor.h
+#pragma once
+#include "TelemetryLog.h"
+#include "neat/Genome.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace neat { struct NEAT; }
+
+namespace telemetry {
+
+struct LiveLayout;   // shared-memory layout, see LiveMonitor.cpp
+
+/// Everything a viewer needs to replay the run's champion locally.
+struct LiveSetup {
+    int32_t  gridW, gridH, maxTicks;
+    int32_t  inputs, outputs;
+    uint8_t  hiddenActivation, outputActivation;   // neat::Activation
+    uint8_t  recurrent;                             // evaluate with RecurrentNetwork
+    uint8_t  fullRays, patch;                       // game::SensorConfig
+};
+
+/// What LiveReader::read() hands back.
+struct LiveSnapshot {
+    uint64_t  sequence = 0;                 // changes on every publish
+    std::vector<GenerationRecord> history;  // oldest first
+    std::vector<SpeciesRecord>    species;  // latest generation
+    bool         hasChampion = false;
+    neat::Genome champion;                  // decoded into local IDs
+};
+
+/**
+ * @brief  Trainer side of the live monitor (POSIX only).
+ *
+ * A named shared-memory segment holding the current champion (GenomeIO
+ * encoding), the last HISTORY generation records and the latest species
+ * summaries. The trainer is the only writer and guards the payload with a
+ * seqlock: the sequence is odd while it writes, so publish() never waits
+ * for a viewer and viewers never block training. The segment is unlinked
+ * when the publisher goes away; attached viewers keep their last copy.
+ */
+class LivePublisher {
+public:
+    static constexpr uint32_t HISTORY        = 256;
+    static constexpr uint32_t MAX_SPECIES    = 128;
+    static constexpr uint32_t CHAMPION_BYTES = 64 * 1024;
+
+    /// Create (replacing any stale one) the segment "/name".
+    static std::unique_ptr<LivePublisher> create(const std::string& name, const LiveSetup& setup);
+    ~LivePublisher();
+
+    /// Publish one generation (call before NEAT::epoch, while species still
+    /// point at the evaluated population). False if the champion does not
+    /// fit; stats are published regardless.
+    bool publish(const GenerationRecord& stats, const neat::NEAT& neat,
+                 const neat::Genome& champion);
+
+private:
+    LivePublisher() = default;
+    LivePublisher(const LivePublisher&)            = delete;
+    LivePublisher& operator=(const LivePublisher&) = delete;
+
+    std::string name_;
+    int         fd_  = -1;
+    LiveLayout* map_ = nullptr;
+    std::vector<uint8_t> buf_;
+};
+
+/**
+ * @brief  Viewer side: attach to a publisher's segment, poll, detach.
+ *
+ * Readers only ever read shared memory, so any number of them can attach
+ * and go away at any time.
+ */
+class LiveReader {
+public:
+    /// nullptr if no trainer publishes under "/name" (yet).
+    static std::unique_ptr<LiveReader> attach(const std::string& name);
+    ~LiveReader();   // detaches
+
+    /// Copy out the latest state if it changed since the last successful
+    /// read. False if nothing new (or the trainer kept writing meanwhile).
+    bool read(LiveSnapshot& out);
+
+    /// The publishing trainer's configuration (fixed for its lifetime).
+    /// Set up the local tracker/activations from it before read() decodes.
+    const LiveSetup& setup() const;
+
+    /// True once a different trainer has published under the same name;
+    /// attach again to follow it.
+    bool replaced() const;
+
+private:
+    LiveReader() = default;
+    LiveReader(const LiveReader&)            = delete;
+    LiveReader& operator=(const LiveReader&) = delete;
+
+    std::string name_;
+    int      fd_  = -1;
+    const LiveLayout* map_ = nullptr;
+    uint64_t inode_    = 0;
+    uint64_t lastSeq_  = 0;
+    std::vector<uint8_t> scratch_;
+};
+
+} // namespace telemetry
@@ -0,0 +1,157 @@
+// LiveViewer.cpp
+//
+// snake-viewer NAME
+//
+// Attaches to a trainer started with --monitor NAME (possibly --headless)
+// and replays its current champion with the normal renderer. The viewer
+// can be started before the trainer, closed and reopened at any time, and
+// follows a restarted trainer under the same name.
+//   D     detach / reattach
+//   ESC   quit
+#include "LiveMonitor.h"
+#include "game/Sensors.h"
+#include "game/Snake.h"
+#include "neat/Activation.h"
+#include "neat/InnovationTracker.h"
+#include "neat/Network.h"
+#include "neat/RecurrentNetwork.h"
+#include "render/Renderer.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <raylib.h>
+
+static constexpr int SCREEN_W = 1200;
+static constexpr int SCREEN_H = 600;
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " NAME\n";
+        return 1;
+    }
+    std::string name = argv[1];
+
+    // decoded champions get throw-away local IDs
+    neat::InnovationTracker::getInstance().disablePersistence();
+
+    std::cout << "Waiting for a trainer publishing to " << name << " ...\n";
+    std::unique_ptr<telemetry::LiveReader> reader;
+    while (!(reader = telemetry::LiveReader::attach(name)))
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    telemetry::LiveSetup setup{};
+    std::unique_ptr<render::Renderer> renderer;
+    std::unique_ptr<game::Snake>      snake;
+    std::mt19937 rng(std::random_device{}());
+    game::Vec2i food{0, 0};
+    int ticks = 0;
+    std::vector<float> inputs;
+    neat::Genome champion;
+    std::unique_ptr<neat::Network>          net;
+    std::unique_ptr<neat::RecurrentNetwork> rnet;
+
+    auto resetSim = [&]() {
+        snake->reset();
+        food  = { std::uniform_int_distribution<int>(0, setup.gridW - 1)(rng),
+                  std::uniform_int_distribution<int>(0, setup.gridH - 1)(rng) };
+        ticks = 0;
+        if (rnet) rnet->reset();
+    };
+
+    // adopt the trainer's configuration (again after following a restart)
+    auto configure = [&]() {
+        const telemetry::LiveSetup& s = reader->setup();
+        neat::InnovationTracker::getInstance().initializeNodeCounter(s.inputs + 1 + s.outputs);
+        neat::setActivation(neat::NodeGene::HIDDEN, neat::Activation(s.hiddenActivation));
+        neat::setActivation(neat::NodeGene::OUTPUT, neat::Activation(s.outputActivation));
+        if (!renderer || s.gridW != setup.gridW || s.gridH != setup.gridH) {
+            renderer.reset();
+            renderer = std::make_unique<render::Renderer>(SCREEN_W, SCREEN_H, s.gridW, s.gridH);
+            SetTargetFPS(10);
+        }
+        setup = s;
+        snake = std::make_unique<game::Snake>(setup.gridW, setup.gridH);
+        resetSim();
+        std::cout << "Attached to " << name << "\n";
+    };
+    configure();
+
+    telemetry::LiveSnapshot snap;
+    telemetry::GenerationRecord latest{};
+    bool haveStats = false;
+    unsigned frame = 0;
+
+    while (!renderer->shouldClose()) {
+        // 1) Poll: a single atomic load unless the trainer published
+        if (reader && reader->read(snap)) {
+            if (!snap.history.empty()) {
+                latest    = snap.history.back();
+                haveStats = true;
+            }
+            if (snap.hasChampion && (!net || snap.champion.contentHash() != champion.contentHash())) {
+                champion = std::move(snap.champion);
+                snap.hasChampion = false;
+                net = std::make_unique<neat::Network>(champion);
+                rnet.reset();
+                if (setup.recurrent) rnet = std::make_unique<neat::RecurrentNetwork>(champion);
+                resetSim();
+            }
+        }
+
+        // 2) Detach on request; follow a trainer restarted under the same name
+        ++frame;
+        if (IsKeyPressed(KEY_D)) {
+            if (reader) {
+                reader.reset();
+                std::cout << "Detached\n";
+            } else if ((reader = telemetry::LiveReader::attach(name))) {
+                configure();
+            }
+        }
+        if (reader && frame % 20 == 0 && reader->replaced()) {
+            if (auto next = telemetry::LiveReader::attach(name)) {
+                reader = std::move(next);
+                configure();
+            }
+        }
+
+        // 3) Replay the champion locally: restart on death or timeout
+        if (net) {
+            game::SensorConfig sensors;
+            sensors.fullRays = setup.fullRays != 0;
+            sensors.patch    = setup.patch;
+            game::sense(*snake, food, sensors, inputs);
+            auto outputs = rnet ? rnet->feed(inputs) : net->feed(inputs);
+            int dir = int(std::distance(outputs.begin(),
+                                        std::max_element(outputs.begin(), outputs.end())));
+            snake->setDirection(static_cast<game::Dir>(dir));
+
+            if (!snake->update() || ++ticks >= setup.maxTicks) {
+                resetSim();
+            } else if (snake->head().x == food.x && snake->head().y == food.y) {
+                snake->grow();
+                food = { std::uniform_int_distribution<int>(0, setup.gridW - 1)(rng),
+                         std::uniform_int_distribution<int>(0, setup.gridH - 1)(rng) };
+            }
+        }
+
+        // 4) Render
+        renderer->beginFrame();
+        renderer->drawGrid();
+        if (net) {
+            renderer->drawSnake(snake->body());
+            renderer->drawFood(food.x, food.y);
+            renderer->drawNetwork(champion, rnet ? rnet->getActivations() : net->getActivations());
+        }
+        if (haveStats)
+            renderer->drawStats(latest.generation, latest.fitMax, latest.fitMean, int(latest.species));
+        DrawText(reader ? "live (D: detach)" : "detached (D: reattach)",
+                 10, SCREEN_H - 30, 20, reader ? DARKGREEN : GRAY);
+        renderer->endFrame();
+    }
+    return 0;
+}
@@ -0,0 +1,32 @@
+// LogFile.h
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace telemetry {
+
+// File helpers shared by the append-only logs
+
+/// Size of f in bytes; leaves the position at the end.
+inline uint64_t fileSize(std::FILE* f) {
+    std::fseek(f, 0, SEEK_END);
+    return uint64_t(std::ftell(f));
+}
+
+/// Cut f down to size bytes, e.g. to drop a torn trailing record before
+/// appending after it.
+inline bool truncateTo(std::FILE* f, uint64_t size) {
+    std::fflush(f);
+#ifdef _WIN32
+    return _chsize_s(_fileno(f), (long long)size) == 0;
+#else
+    return ftruncate(fileno(f), off_t(size)) == 0;
+#endif
+}
+
+} // namespace telemetry
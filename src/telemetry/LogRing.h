@@ -0,0 +1,109 @@
+// LogRing.h
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace telemetry {
+
+/**
+ * @brief  Bounded single-producer/single-consumer queue between the
+ *         training thread and a log's writer thread.
+ *
+ * push() copies the item into the ring and returns immediately. If the
+ * writer falls behind and the ring fills up, items are dropped (and
+ * counted) rather than blocking the producer, so memory stays bounded.
+ */
+template<typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        size_t cap = 1;
+        while (cap < capacity) cap <<= 1;
+        slots_.resize(cap);
+        mask_ = cap - 1;
+    }
+
+    // Producer side; call from one thread only. False if the item was dropped.
+    bool push(const T& item) {
+        uint64_t h = head_.load(std::memory_order_relaxed);
+        if (h - tail_.load(std::memory_order_acquire) > mask_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots_[h & mask_] = item;
+        head_.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: pass up to max queued items to fn, oldest first, then
+    // release their slots. Returns how many were taken.
+    template<typename F>
+    size_t drain(F&& fn, size_t max = SIZE_MAX) {
+        uint64_t t = tail_.load(std::memory_order_relaxed);
+        uint64_t h = head_.load(std::memory_order_acquire);
+        size_t n = 0;
+        for (; t != h && n < max; ++t, ++n) fn(slots_[t & mask_]);
+        tail_.store(t, std::memory_order_release);
+        return n;
+    }
+
+    /// Consumer side: nothing is queued.
+    bool empty() const {
+        return tail_.load(std::memory_order_relaxed) == head_.load(std::memory_order_acquire);
+    }
+
+    /// Count items the consumer took but had to give up on.
+    void dropTaken(uint64_t n) { dropped_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<uint64_t> head_{0};    // next slot to fill
+    alignas(64) std::atomic<uint64_t> tail_{0};    // next slot to write
+    std::atomic<uint64_t> dropped_{0};
+};
+
+/**
+ * @brief  A log's background writer thread.
+ *
+ * Calls step(stopping) over and over; step consumes some of the log's
+ * ring and returns true once the ring is drained, after which the thread
+ * naps briefly. stop() lets it drain everything pushed before the call,
+ * then joins it. Owners call stop() before closing their files.
+ */
+class WriterThread {
+public:
+    WriterThread() = default;
+    ~WriterThread() { stop(); }
+
+    void start(std::function<bool(bool stopping)> step) {
+        thread_ = std::thread([this, step] {
+            for (;;) {
+                // read stop first so that a final drain sees everything pushed before it
+                bool stopping = stop_.load(std::memory_order_acquire);
+                if (!step(stopping)) continue;
+                if (stopping) return;
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+        });
+    }
+
+    void stop() {
+        stop_.store(true, std::memory_order_release);
+        if (thread_.joinable()) thread_.join();
+    }
+
+private:
+    WriterThread(const WriterThread&)            = delete;
+    WriterThread& operator=(const WriterThread&) = delete;
+
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+} // namespace telemetry
@@ -0,0 +1,107 @@
+// Sampler.cpp
+#include "Sampler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace telemetry {
+
+static uint32_t enabledConnections(const neat::Genome& g) {
+    uint32_t n = 0;
+    for (size_t i = 0; i < g.connections.size(); ++i) n += g.connections.enabled(i);
+    return n;
+}
+
+GenerationRecord sampleGeneration(const neat::NEAT& neat) {
+    GenerationRecord r{};
+    const auto& pop = neat.population();
+    r.generation      = neat.generation;
+    r.population      = uint32_t(pop.size());
+    r.species         = uint32_t(neat.species().size());
+    r.compatThreshold = neat.compatThreshold();
+    if (pop.empty()) return r;
+
+    std::vector<float> fit;
+    fit.reserve(pop.size());
+    double sum = 0.0, sumNodes = 0.0, sumConns = 0.0;
+    for (const neat::Genome* g : pop) {
+        fit.push_back(g->fitness);
+        sum += g->fitness;
+        uint32_t nodes = uint32_t(g->nodes.size());
+        uint32_t conns = enabledConnections(*g);
+        sumNodes += nodes;
+        sumConns += conns;
+        r.nodesMax = std::max(r.nodesMax, nodes);
+        r.connsMax = std::max(r.connsMax, conns);
+    }
+    std::sort(fit.begin(), fit.end());
+    auto quantile = [&](double q) { return fit[size_t(q * (fit.size() - 1) + 0.5)]; };
+
+    double mean = sum / fit.size();
+    double var  = 0.0;
+    for (float f : fit) var += (f - mean) * (f - mean);
+
+    r.fitMin    = fit.front();
+    r.fitP25    = quantile(0.25);
+    r.fitMedian = quantile(0.5);
+    r.fitP75    = quantile(0.75);
+    r.fitMax    = fit.back();
+    r.fitMean   = float(mean);
+    r.fitStddev = float(std::sqrt(var / fit.size()));
+    r.nodesMean = float(sumNodes / pop.size());
+    r.connsMean = float(sumConns / pop.size());
+    return r;
+}
+
+std::vector<SpeciesRecord> sampleSpecies(const neat::NEAT& neat) {
+    const auto& species = neat.species();
+    std::vector<SpeciesRecord> out;
+    out.reserve(species.size());
+    for (size_t i = 0; i < species.size(); ++i) {
+        const neat::Species& s = species[i];
+        SpeciesRecord r{};
+        r.generation           = neat.generation;
+        r.index                = uint32_t(i);
+        r.members              = s.count;
+        r.bestFitnessEver      = s.bestFitnessEver;
+        r.gensSinceImprovement = s.gensSinceImprovement;
+        if (s.count > 0) {
+            double sum = 0.0, nodes = 0.0, conns = 0.0;
+            r.bestFitness = neat.member(s, 0)->fitness;
+            for (uint32_t k = 0; k < s.count; ++k) {
+                const neat::Genome* g = neat.member(s, k);
+                r.bestFitness = std::max(r.bestFitness, g->fitness);
+                sum   += g->fitness;
+                nodes += g->nodes.size();
+                conns += enabledConnections(*g);
+            }
+            r.meanFitness = float(sum / s.count);
+            r.nodesMean   = float(nodes / s.count);
+            r.connsMean   = float(conns / s.count);
+        }
+        out.push_back(r);
+    }
+    return out;
+}
+
+void pushSpecies(TelemetryWriter& log, const neat::NEAT& neat) {
+    for (const SpeciesRecord& r : sampleSpecies(neat)) log.push(r);
+}
+
+void pushGenealogy(GenealogyWriter& log, const neat::NEAT& neat) {
+    GenealogyRecord r{};
+    r.generation = neat.generation;
+    for (const auto& s : neat.species()) {
+        r.species = s.id;
+        for (uint32_t k = 0; k < s.count; ++k) {
+            const neat::Genome* g = neat.member(s, k);
+            r.id         = g->lineage.id;
+            r.parents[0] = g->lineage.parents[0];
+            r.parents[1] = g->lineage.parents[1];
+            r.fitness    = float(g->fitness);
+            r.origin     = g->lineage.origin;
+            log.push(r);
+        }
+    }
+}
+
+} // namespace telemetry
@@ -0,0 +1,23 @@
+// Sampler.h
+#pragma once
+#include "TelemetryLog.h"
+#include "Genealogy.h"
+#include "neat/NEAT.h"
+#include <vector>
+
+namespace telemetry {
+
+/// Statistics of the evaluated population (call before NEAT::epoch, while
+/// species members still point at it). Phase timings are left at zero.
+GenerationRecord sampleGeneration(const neat::NEAT& neat);
+
+/// One SpeciesRecord per current species (same timing as above).
+std::vector<SpeciesRecord> sampleSpecies(const neat::NEAT& neat);
+
+/// Queue one SpeciesRecord per current species.
+void pushSpecies(TelemetryWriter& log, const neat::NEAT& neat);
+
+/// Queue one GenealogyRecord per evaluated genome (same timing as above).
+void pushGenealogy(GenealogyWriter& log, const neat::NEAT& neat);
+
+} // namespace telemetry
@@ -0,0 +1,53 @@
+// TelemetryCsv.cpp
+//
+// Export a SnakeNEAT telemetry log as CSV:
+//   snake-telemetry RUN.sntl [generations|species] > out.csv
+
+#include "TelemetryLog.h"
+#include <cstring>
+#include <iostream>
+
+using namespace telemetry;
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "usage: " << argv[0] << " LOG [generations|species]\n";
+        return 2;
+    }
+    bool species = argc == 3 && std::strcmp(argv[2], "species") == 0;
+    if (argc == 3 && !species && std::strcmp(argv[2], "generations") != 0) {
+        std::cerr << "unknown table " << argv[2] << "\n";
+        return 2;
+    }
+
+    std::ostream& out = std::cout;
+    if (species)
+        out << "generation,species,members,best_fitness,mean_fitness,best_fitness_ever,"
+               "gens_since_improvement,nodes_mean,conns_mean\n";
+    else
+        out << "generation,population,species,compat_threshold,"
+               "fit_min,fit_p25,fit_median,fit_p75,fit_max,fit_mean,fit_stddev,"
+               "nodes_mean,conns_mean,nodes_max,conns_max,eval_ms,render_ms,epoch_ms\n";
+
+    bool ok = readTelemetry(argv[1],
+        [&](const GenerationRecord& r) {
+            if (species) return;
+            out << r.generation << ',' << r.population << ',' << r.species << ','
+                << r.compatThreshold << ','
+                << r.fitMin << ',' << r.fitP25 << ',' << r.fitMedian << ','
+                << r.fitP75 << ',' << r.fitMax << ',' << r.fitMean << ',' << r.fitStddev << ','
+                << r.nodesMean << ',' << r.connsMean << ',' << r.nodesMax << ',' << r.connsMax << ','
+                << r.evalMs << ',' << r.renderMs << ',' << r.epochMs << '\n';
+        },
+        [&](const SpeciesRecord& r) {
+            if (!species) return;
+            out << r.generation << ',' << r.index << ',' << r.members << ','
+                << r.bestFitness << ',' << r.meanFitness << ',' << r.bestFitnessEver << ','
+                << r.gensSinceImprovement << ',' << r.nodesMean << ',' << r.connsMean << '\n';
+        });
+    if (!ok) {
+        std::cerr << argv[1] << ": not a telemetry log\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+// TelemetryLog.cpp
+#include "TelemetryLog.h"
+#include "LogFile.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+namespace telemetry {
+
+static constexpr char     LOG_MAGIC[4]  = { 'S', 'N', 'T', 'L' };
+static constexpr uint16_t LOG_VERSION   = 1;
+
+// record tags
+static constexpr uint8_t TAG_GENERATION = 1;
+static constexpr uint8_t TAG_SPECIES    = 2;
+
+struct LogHeader {
+    char     magic[4];
+    uint16_t version;
+    uint16_t generationBytes;
+    uint16_t speciesBytes;
+    uint16_t reserved0;
+    uint32_t reserved1;
+};
+static_assert(sizeof(LogHeader) == 16, "log header is 16 bytes");
+
+static LogHeader currentHeader() {
+    LogHeader h{};
+    std::memcpy(h.magic, LOG_MAGIC, 4);
+    h.version         = LOG_VERSION;
+    h.generationBytes = uint16_t(sizeof(GenerationRecord));
+    h.speciesBytes    = uint16_t(sizeof(SpeciesRecord));
+    return h;
+}
+
+static bool sameLayout(const LogHeader& a, const LogHeader& b) {
+    return std::memcmp(a.magic, b.magic, 4) == 0 && a.version == b.version &&
+           a.generationBytes == b.generationBytes && a.speciesBytes == b.speciesBytes;
+}
+
+std::unique_ptr<TelemetryWriter> TelemetryWriter::open(const std::string& path, size_t capacity) {
+    std::FILE* f = std::fopen(path.c_str(), "ab+");
+    if (!f) {
+        std::cerr << "Telemetry: cannot open " << path << ": " << std::strerror(errno) << "\n";
+        return nullptr;
+    }
+
+    // new file: write the header; existing one: must have our layout
+    LogHeader want = currentHeader();
+    uint64_t size = fileSize(f);
+    if (size == 0) {
+        if (std::fwrite(&want, sizeof(want), 1, f) != 1) {
+            std::fclose(f);
+            return nullptr;
+        }
+    } else {
+        LogHeader have{};
+        std::fseek(f, 0, SEEK_SET);
+        bool ok = std::fread(&have, sizeof(have), 1, f) == 1 && sameLayout(have, want);
+        if (!ok) {
+            std::cerr << "Telemetry: " << path << " is not a log of this version, not appending\n";
+            std::fclose(f);
+            return nullptr;
+        }
+        // a crash can leave a torn record at the end; appending after it
+        // would hide everything written from now on, so cut it off
+        uint64_t end = sizeof(LogHeader);
+        int tag;
+        while ((tag = std::fgetc(f)) != EOF) {
+            uint64_t bytes = tag == TAG_GENERATION ? sizeof(GenerationRecord)
+                           : tag == TAG_SPECIES    ? sizeof(SpeciesRecord) : 0;
+            if (bytes == 0 || end + 1 + bytes > size ||
+                std::fseek(f, long(bytes), SEEK_CUR) != 0) break;
+            end += 1 + bytes;
+        }
+        if (end < size) {
+            std::cerr << "Telemetry: " << path << ": dropping " << (size - end)
+                      << " byte(s) of a torn record at the end\n";
+            if (!truncateTo(f, end)) {
+                std::cerr << "Telemetry: cannot truncate " << path << ", not appending\n";
+                std::fclose(f);
+                return nullptr;
+            }
+        }
+        std::fseek(f, 0, SEEK_END);
+    }
+
+    std::unique_ptr<TelemetryWriter> w(new TelemetryWriter(capacity));
+    w->file_ = f;
+    TelemetryWriter* self = w.get();
+    w->writer_.start([self](bool stopping) { return self->step(stopping); });
+    return w;
+}
+
+TelemetryWriter::~TelemetryWriter() {
+    writer_.stop();
+    if (file_) std::fclose(file_);
+    if (dropped() > 0)
+        std::cerr << "Telemetry: " << dropped() << " record(s) dropped, writer fell behind\n";
+}
+
+bool TelemetryWriter::push(const GenerationRecord& r) {
+    Entry e;
+    e.tag = TAG_GENERATION;
+    e.gen = r;
+    return ring_.push(e);
+}
+
+bool TelemetryWriter::push(const SpeciesRecord& r) {
+    Entry e;
+    e.tag     = TAG_SPECIES;
+    e.species = r;
+    return ring_.push(e);
+}
+
+bool TelemetryWriter::step(bool) {
+    // serialize the whole backlog, release the slots, then do the I/O
+    buf_.clear();
+    ring_.drain([this](const Entry& e) {
+        const void* rec  = e.tag == TAG_GENERATION ? static_cast<const void*>(&e.gen)
+                                                   : static_cast<const void*>(&e.species);
+        size_t      size = e.tag == TAG_GENERATION ? sizeof(GenerationRecord)
+                                                   : sizeof(SpeciesRecord);
+        buf_.push_back(e.tag);
+        buf_.insert(buf_.end(), static_cast<const uint8_t*>(rec),
+                    static_cast<const uint8_t*>(rec) + size);
+    });
+    if (buf_.empty()) return true;
+
+    if (std::fwrite(buf_.data(), 1, buf_.size(), file_) != buf_.size())
+        std::cerr << "Telemetry: write failed\n";
+    std::fflush(file_);
+    return true;
+}
+
+bool readTelemetry(const std::string& path,
+                   const std::function<void(const GenerationRecord&)>& onGeneration,
+                   const std::function<void(const SpeciesRecord&)>& onSpecies) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+
+    LogHeader h{};
+    if (std::fread(&h, sizeof(h), 1, f) != 1 || !sameLayout(h, currentHeader())) {
+        std::fclose(f);
+        return false;
+    }
+
+    int tag;
+    while ((tag = std::fgetc(f)) != EOF) {
+        if (tag == TAG_GENERATION) {
+            GenerationRecord r;
+            if (std::fread(&r, sizeof(r), 1, f) != 1) break;
+            if (onGeneration) onGeneration(r);
+        } else if (tag == TAG_SPECIES) {
+            SpeciesRecord r;
+            if (std::fread(&r, sizeof(r), 1, f) != 1) break;
+            if (onSpecies) onSpecies(r);
+        } else {
+            break;   // garbage: stop at the last good record
+        }
+    }
+    std::fclose(f);
+    return true;
+}
+
+} // namespace telemetry
@@ -0,0 +1,94 @@
+// TelemetryLog.h
+#pragma once
+#include "LogRing.h"
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace telemetry {
+
+/// One row per generation. Fixed-size POD, written as-is.
+struct GenerationRecord {
+    int32_t  generation;
+    uint32_t population;
+    uint32_t species;
+    float    compatThreshold;
+    // fitness distribution
+    float    fitMin, fitP25, fitMedian, fitP75, fitMax;
+    float    fitMean, fitStddev;
+    // genome sizes (enabled connections)
+    float    nodesMean, connsMean;
+    uint32_t nodesMax, connsMax;
+    // wall time per phase, milliseconds
+    float    evalMs, renderMs, epochMs;
+};
+
+/// One row per species and generation.
+struct SpeciesRecord {
+    int32_t  generation;
+    uint32_t index;                 // position in NEAT::species()
+    uint32_t members;
+    float    bestFitness, meanFitness, bestFitnessEver;
+    int32_t  gensSinceImprovement;
+    float    nodesMean, connsMean;
+};
+
+static_assert(std::is_trivially_copyable<GenerationRecord>::value, "written raw");
+static_assert(std::is_trivially_copyable<SpeciesRecord>::value,    "written raw");
+
+/**
+ * @brief  Append-only binary run log, written off the training thread.
+ *
+ * push() queues a record on an SpscRing (LogRing.h) and never blocks the
+ * generation loop; a background thread drains the ring into the file.
+ *
+ * File layout: a 16-byte header ("SNTL", version, record sizes) followed
+ * by records, each a one-byte tag and the raw struct in host byte order.
+ * Reopening an existing log with the same layout appends to it.
+ */
+class TelemetryWriter {
+public:
+    /// Open (or append to) path. Returns nullptr on failure.
+    static std::unique_ptr<TelemetryWriter> open(const std::string& path,
+                                                 size_t capacity = 8192);
+    ~TelemetryWriter();   // drains what is queued, then closes the file
+
+    // Producer side; call from one thread only. False if the record was dropped.
+    bool push(const GenerationRecord& r);
+    bool push(const SpeciesRecord& r);
+
+    uint64_t dropped() const { return ring_.dropped(); }
+
+private:
+    struct Entry {
+        uint8_t tag;
+        union {
+            GenerationRecord gen;
+            SpeciesRecord    species;
+        };
+    };
+
+    explicit TelemetryWriter(size_t capacity) : ring_(capacity) {}
+    TelemetryWriter(const TelemetryWriter&)            = delete;
+    TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+    // writer thread: append the whole backlog to the file
+    bool step(bool stopping);
+
+    std::FILE* file_ = nullptr;
+    std::vector<uint8_t> buf_;          // writer thread only
+    SpscRing<Entry> ring_;
+    WriterThread writer_;
+};
+
+/// Read every record in a log. A truncated trailing record (e.g. after a
+/// crash) is ignored. Returns false if the file is missing or not a log.
+bool readTelemetry(const std::string& path,
+                   const std::function<void(const GenerationRecord&)>& onGeneration,
+                   const std::function<void(const SpeciesRecord&)>& onSpecies);
+
+} // namespace telemetry